@@ -14,9 +14,15 @@ HEADERS += interfaces/SolAR2D3DcorrespondencesFinderOpencv.h \
     interfaces/SolARDescriptorsExtractorORBOpencv.h \
     interfaces/SolARDescriptorsExtractorSBPatternOpencv.h \
     interfaces/SolARDescriptorsExtractorSIFTOpencv.h \
+    interfaces/SolARDenseOpticalFlowOpencv.h \
+    interfaces/IFrameMotionEstimator.h \
     interfaces/SolARDeviceDataLoader.h \
+    interfaces/SolARFastGaussian.h \
+    interfaces/SolARFiducialMarkerDetectorOpencv.h \
     interfaces/SolARFiducialMarkerLoaderOpencv.h \
+    interfaces/IFiducialMarkerDetector.h \
     interfaces/SolARFundamentalMatrixEstimationOpencv.h \
+    interfaces/SolAREpipolarRANSAC.h \
     interfaces/SolARGeometricMatchesFilterOpencv.h \
     interfaces/SolARHomographyEstimationOpencv.h \
     interfaces/SolARHomographyMatrixDecomposerOpencv.h \
@@ -25,6 +31,7 @@ HEADERS += interfaces/SolAR2D3DcorrespondencesFinderOpencv.h \
     interfaces/SolARImageFilterAdaptiveBinaryOpencv.h \
     interfaces/SolARImageFilterBinaryOpencv.h \
     interfaces/SolARImageFilterBlurOpencv.h \
+    interfaces/SolARImageFilterChainOpencv.h \
     interfaces/SolARImageFilterDilateOpencv.h \
     interfaces/SolARImageFilterErodeOpencv.h \
     interfaces/SolARImageLoaderOpencv.h \
@@ -32,6 +39,7 @@ HEADERS += interfaces/SolAR2D3DcorrespondencesFinderOpencv.h \
     interfaces/SolARImageViewerOpencv.h \
     interfaces/SolARKeypointDetectorOpencv.h \
     interfaces/SolARKeypointDetectorRegionOpencv.h \
+    interfaces/SolARLatencyProfiler.h \
     interfaces/SolARMapFusionOpencv.h \
     interfaces/SolARMarker2DNaturalImageOpencv.h \
     interfaces/SolARMarker2DSquaredBinaryOpencv.h \
@@ -48,9 +56,12 @@ HEADERS += interfaces/SolAR2D3DcorrespondencesFinderOpencv.h \
     interfaces/SolARProjectOpencv.h \
     interfaces/SolARSVDFundamentalMatrixDecomposerOpencv.h\
     interfaces/SolARUndistortPointsOpencv.h \
+    interfaces/SolARUndistortionGrid.h \
     interfaces/SolARUnprojectPlanarPointsOpencv.h \
     interfaces/SolARSVDTriangulationOpencv.h \
     interfaces/SolARVideoAsCameraOpencv.h \
+    interfaces/SolARVideoRecorderOpencv.h \
+    interfaces/IImageRecorder.h \
     src/AKAZE2/AKAZEConfig.h \
     src/AKAZE2/AKAZEFeatures.h \
     src/AKAZE2/fed.h \
@@ -78,9 +89,13 @@ SOURCES +=  src/AKAZE2/akaze.cpp \
     src/SolARDescriptorsExtractorORBOpencv.cpp \
     src/SolARDescriptorsExtractorSBPatternOpencv.cpp \
     src/SolARDescriptorsExtractorSIFTOpencv.cpp \
+    src/SolARDenseOpticalFlowOpencv.cpp \
     src/SolARDeviceDataLoader.cpp \
+    src/SolARFastGaussian.cpp \
+    src/SolARFiducialMarkerDetectorOpencv.cpp \
     src/SolARFiducialMarkerLoaderOpencv.cpp \
     src/SolARFundamentalMatrixEstimationOpencv.cpp \
+    src/SolAREpipolarRANSAC.cpp \
     src/SolARGeometricMatchesFilterOpencv.cpp \
     src/SolARHomographyEstimationOpencv.cpp \
     src/SolARHomographyMatrixDecomposerOpencv.cpp \
@@ -89,6 +104,7 @@ SOURCES +=  src/AKAZE2/akaze.cpp \
     src/SolARImageFilterAdaptiveBinaryOpencv.cpp \
     src/SolARImageFilterBinaryOpencv.cpp \
     src/SolARImageFilterBlurOpencv.cpp \
+    src/SolARImageFilterChainOpencv.cpp \
     src/SolARImageFilterDilateOpencv.cpp \
     src/SolARImageFilterErodeOpencv.cpp \
     src/SolARImageLoaderOpencv.cpp \
@@ -96,6 +112,7 @@ SOURCES +=  src/AKAZE2/akaze.cpp \
     src/SolARImageViewerOpencv.cpp \
     src/SolARKeypointDetectorOpencv.cpp \
     src/SolARKeypointDetectorRegionOpencv.cpp \
+    src/SolARLatencyProfiler.cpp \
     src/SolARMapFusionOpencv.cpp \
     src/SolARMarker2DNaturalImageOpencv.cpp \
     src/SolARMarker2DSquaredBinaryOpencv.cpp \
@@ -112,8 +129,10 @@ SOURCES +=  src/AKAZE2/akaze.cpp \
     src/SolARSVDFundamentalMatrixDecomposerOpencv.cpp \
     src/SolARSVDTriangulationOpencv.cpp \
     src/SolARUndistortPointsOpencv.cpp \
+    src/SolARUndistortionGrid.cpp \
     src/SolARUnprojectplanarPointsOpencv.cpp \
-    src/SolARVideoAsCameraOpencv.cpp
+    src/SolARVideoAsCameraOpencv.cpp \
+    src/SolARVideoRecorderOpencv.cpp
 
 
 
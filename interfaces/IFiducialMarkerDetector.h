@@ -0,0 +1,64 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef IFIDUCIALMARKERDETECTOR_H
+#define IFIDUCIALMARKERDETECTOR_H
+
+#include <vector>
+
+#include "xpcf/api/IComponentIntrospect.h"
+#include "core/Messages.h"
+#include "datastructure/Image.h"
+#include "datastructure/DescriptorBuffer.h"
+#include "datastructure/GeometryDefinitions.h"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class IFiducialMarkerDetector
+ * @brief <B>Detects the squared binary markers of an image.</B>
+ * <TT>UUID: d344c6a4-9fce-40d7-8a1d-ca3971e7c56d</TT>
+ *
+ * The outputs are the ones of the chain image convertor, binary filter, contours extractor, contours filter,
+ * perspective controller and SBPattern descriptors extractor, so they can be given to the same matcher.
+ */
+class IFiducialMarkerDetector : virtual public org::bcom::xpcf::IComponentIntrospect {
+public:
+    /// @brief IFiducialMarkerDetector default destructor
+    virtual ~IFiducialMarkerDetector() = default;
+
+    /// @brief Detects the squared binary markers of an image.
+    /// @param[in] image: the input image, grey or color.
+    /// @param[out] descriptors: for each recognized marker, the descriptors of its pattern and of its three 90° counter-clockwise rotations.
+    /// @param[out] contours: the four corners of each recognized marker, one contour per descriptor, rotated like the descriptor.
+    /// @return FrameworkReturnCode::_SUCCESS if the detection succeeded, else FrameworkReturnCode::_ERROR_
+    virtual FrameworkReturnCode detect(const SRef<datastructure::Image> image,
+                                       SRef<datastructure::DescriptorBuffer> & descriptors,
+                                       std::vector<datastructure::Contour2Df> & contours) = 0;
+};
+
+}
+}
+}
+
+XPCF_DEFINE_INTERFACE_TRAITS(SolAR::MODULES::OPENCV::IFiducialMarkerDetector,
+                             "d344c6a4-9fce-40d7-8a1d-ca3971e7c56d",
+                             "IFiducialMarkerDetector",
+                             "SolAR::MODULES::OPENCV::IFiducialMarkerDetector");
+
+#endif // IFIDUCIALMARKERDETECTOR_H
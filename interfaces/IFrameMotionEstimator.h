@@ -0,0 +1,60 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef IFRAMEMOTIONESTIMATOR_H
+#define IFRAMEMOTIONESTIMATOR_H
+
+#include "xpcf/api/IComponentIntrospect.h"
+#include "core/Messages.h"
+#include "datastructure/Image.h"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class IFrameMotionEstimator
+ * @brief <B>Estimates the motion and the blur of each frame of a video stream.</B>
+ * <TT>UUID: 8eab812a-86e1-4064-bda8-18b9d37f6193</TT>
+ *
+ * The measures let a pipeline skip the feature extraction and the keyframe tests on the frames with little motion or heavy blur.
+ */
+class IFrameMotionEstimator : virtual public org::bcom::xpcf::IComponentIntrospect {
+public:
+    /// @brief IFrameMotionEstimator default destructor
+    virtual ~IFrameMotionEstimator() = default;
+
+    /// @brief Estimates the motion between the previous frame given to the estimator and a new frame, and the blur of the new frame.
+    /// @param[in] image: the new frame of the stream.
+    /// @param[out] medianFlow: the median magnitude of the motion of the pixels since the previous frame, in pixels of the frame, 0 for the first frame.
+    /// @param[out] blurScore: the blur of the frame, from 0 for a frame as sharp as the sharpest recent frames to 1 for a frame without any detail.
+    /// @return FrameworkReturnCode::_SUCCESS if the estimation succeeded, else FrameworkReturnCode::_ERROR_
+    virtual FrameworkReturnCode estimate(const SRef<datastructure::Image> image,
+                                         float & medianFlow,
+                                         float & blurScore) = 0;
+};
+
+}
+}
+}
+
+XPCF_DEFINE_INTERFACE_TRAITS(SolAR::MODULES::OPENCV::IFrameMotionEstimator,
+                             "8eab812a-86e1-4064-bda8-18b9d37f6193",
+                             "IFrameMotionEstimator",
+                             "SolAR::MODULES::OPENCV::IFrameMotionEstimator");
+
+#endif // IFRAMEMOTIONESTIMATOR_H
@@ -0,0 +1,70 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef IIMAGERECORDER_H
+#define IIMAGERECORDER_H
+
+#include "xpcf/api/IComponentIntrospect.h"
+#include "core/Messages.h"
+#include "datastructure/Image.h"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class IImageRecorder
+ * @brief <B>Records a stream of timestamped images.</B>
+ * <TT>UUID: ffab5c54-ec65-4809-a93a-03b1ba91efd7</TT>
+ *
+ * The output counterpart of a camera, used to keep the raw frames or the overlays of a pipeline for a later analysis.
+ */
+class IImageRecorder : virtual public org::bcom::xpcf::IComponentIntrospect {
+public:
+    /// @brief IImageRecorder default destructor
+    virtual ~IImageRecorder() = default;
+
+    /// @brief Records an image, the image can be modified or released as soon as the method returns.
+    /// @param[in] image: the image to record.
+    /// @param[in] timestamp: the timestamp of the image in milliseconds.
+    /// @return FrameworkReturnCode::_SUCCESS if the image is recorded or dropped by the drop policy, else FrameworkReturnCode::_ERROR_
+    virtual FrameworkReturnCode record(const SRef<datastructure::Image> image, double timestamp) = 0;
+
+    /// @brief Writes the pending images and closes the output, the next image starts a new recording.
+    /// @return FrameworkReturnCode::_SUCCESS if all the images have been written, else FrameworkReturnCode::_ERROR_
+    virtual FrameworkReturnCode close() = 0;
+
+    /// @brief Returns the number of images waiting to be written.
+    virtual uint32_t getQueueDepth() const = 0;
+
+    /// @brief Returns the number of images dropped since the start of the recording.
+    virtual uint32_t getNbDroppedImages() const = 0;
+
+    /// @brief Returns the number of images written since the start of the recording.
+    virtual uint32_t getNbRecordedImages() const = 0;
+};
+
+}
+}
+}
+
+XPCF_DEFINE_INTERFACE_TRAITS(SolAR::MODULES::OPENCV::IImageRecorder,
+                             "ffab5c54-ec65-4809-a93a-03b1ba91efd7",
+                             "IImageRecorder",
+                             "SolAR::MODULES::OPENCV::IImageRecorder");
+
+#endif // IIMAGERECORDER_H
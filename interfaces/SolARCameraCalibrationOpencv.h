@@ -19,7 +19,9 @@
 
 #include "api/input/devices/ICameraCalibration.h"
 
+#include <atomic>
 #include <string>
+#include <vector>
 #include "opencv2/videoio.hpp"
 #include "xpcf/component/ComponentBase.h"
 
@@ -34,6 +36,15 @@ namespace OPENCV {
  * @brief <B>Calibrates a camera based on a chessboard.</B>
  * <TT>UUID: 702a7f53-e5ec-45d2-887d-daa99a34a33c</TT>
  *
+ * The frames are decoded by batches of one frame per thread, and the chessboard of a batch is searched in parallel
+ * while the next batch is decoded. The chessboard is first searched with a fast check in a frame downscaled to
+ * detection_width pixels, its corners are then refined in the full resolution frame.
+ * A view is selected only if its corners moved by more than min_view_distance times the image diagonal on average
+ * from the ones of every view already selected. While capturing, the camera is calibrated again in the background
+ * every time a view is selected, from the previous estimate, and its RMS error is logged and displayed.
+ * The final calibration is run from scratch on all the selected views.
+ * A video file is captured without waiting for a key, a camera waits for 'g' to start.
+ *
  */
 
 class SOLAROPENCV_EXPORT_API SolARCameraCalibrationOpencv :
@@ -65,6 +76,8 @@ public:
     /// @param[in] Camera calibration matrix parameters.
     /// @param[in] Camera distorsion parameters.
     bool setParameters(const std::string & config_file) override;
+    /// @brief Returns the RMS error of the last calibration run while capturing, or a negative value before the first one.
+    double getCurrentRMS() const;
 	virtual void unloadComponent() override;
 
 
@@ -82,7 +95,18 @@ protected:
 	int m_flags;
 	int m_delay;
 
+	// optional parameters of the selection of the views
+	int m_detectionWidth = 640;
+	float m_minViewDistance = 0.05f;
+	std::atomic<double> m_currentRMS{-1.};
+
     virtual bool process(cv::VideoCapture &, const std::string &);
+
+    /// @brief Searches the chessboard with a fast check in the frame downscaled to m_detectionWidth, and at full resolution if it is not found, then refines its corners at full resolution.
+    bool detectCorners(const cv::Mat & view, std::vector<cv::Point2f> & corners) const;
+
+    /// @brief Returns true if the corners moved by more than m_minViewDistance times the image diagonal on average from the ones of every selected view, in either corner order.
+    bool isNewView(const std::vector<std::vector<cv::Point2f>> & imagePoints, const std::vector<cv::Point2f> & corners, cv::Size imageSize) const;
 	
 	static double computeReprojectionErrors(const std::vector<std::vector<cv::Point3f> >& objectPoints,
 		const std::vector<std::vector<cv::Point2f> >& imagePoints,
@@ -22,6 +22,8 @@
 #include "xpcf/component/ConfigurableBase.h"
 #include "SolAROpencvAPI.h"
 
+#include "opencv2/core.hpp"
+
 namespace SolAR {
 namespace MODULES {
 namespace OPENCV {
@@ -35,6 +37,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ minContourEdges,
  *                          the minimum number of edges of a contour to extract. If negative value\, extract all contours,
  *                          @SolARComponentPropertyDescNum{ int, [-1..MAX INT], -1 }}
+ * @SolARComponentProperty{ chainApproximation,
+ *                          0 to extract every point of the contours\, 1 to compress their horizontal\, vertical and diagonal segments to their end points,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  *
  */
@@ -54,6 +59,12 @@ public:
 private:
     /// @brief The minimum number of edges of a contour to extract. If negative value, extract all contours.
     int m_minContourEdges = -1;
+
+    /// @brief 0 to extract every point of the contours (cv::CHAIN_APPROX_NONE), 1 to compress their segments (cv::CHAIN_APPROX_SIMPLE).
+    /// The length of a compressed contour compared to minContourEdges is the number of points it would have uncompressed.
+    int m_chainApproximation = 0;
+
+    std::vector<std::vector<cv::Point>> m_ocvContours;
 };
 
 }
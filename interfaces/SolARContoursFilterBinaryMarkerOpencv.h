@@ -22,6 +22,8 @@
 #include "xpcf/component/ConfigurableBase.h"
 #include "SolAROpencvAPI.h"
 
+#include "opencv2/core.hpp"
+
 namespace SolAR {
 namespace MODULES {
 namespace OPENCV {
@@ -62,6 +64,21 @@ public:
     FrameworkReturnCode filter(const std::vector<datastructure::Contour2Df> & input_contours, std::vector<datastructure::Contour2Df> & output_contours) override;
     void unloadComponent () override final; 
 
+    /// @brief Approximates a contour by a convex quadrilateral whose corners are sorted in anti-clockwise order.
+    /// @param[in] contour: the contour, a vector of cv::Point or cv::Point2f.
+    /// @param[in] epsilon: the approximation accuracy relatively to the uncompressed length of the contour.
+    /// @param[in] minContourLength: the minimum squared length of an edge of the quadrilateral.
+    /// @param[out] quad: the four corners of the quadrilateral.
+    /// @return true if the contour is a convex quadrilateral with edges long enough.
+    static bool approximateQuad(cv::InputArray contour, float epsilon, float minContourLength, datastructure::Contour2Df & quad);
+
+    /// @brief Removes the quadrilaterals whose corners are on average too close to the corners of a quadrilateral with a bigger perimeter.
+    /// Only the quadrilaterals whose centroids fall in neighboring cells of a grid are compared, the perimeters are computed once per quadrilateral.
+    /// @param[in] candidates: the quadrilaterals.
+    /// @param[in] minDistanceBetweenContourCorners: the minimum average distance in pixels between the corners of two kept quadrilaterals.
+    /// @param[out] filtered: the kept quadrilaterals, in the order of the candidates.
+    static void removeTooNearCandidates(const std::vector<datastructure::Contour2Df> & candidates, float minDistanceBetweenContourCorners, std::vector<datastructure::Contour2Df> & filtered);
+
 private:    
     /// @brief The maximum distance between the original curve and its approximation.
     /// This filter first simplifies the contour if its curve is low. The simplified contour will not be more than epsilon pixels away from the original contour.
@@ -74,6 +91,8 @@ private:
     /// @brief The minimum average distance in pixels between corners of a contour and the same corners of another contour
     /// If the corners are too close from the same corners of another contour, the contour with the lower perimeter is removed
     float m_minDistanceBetweenContourCorners = 10.0f;
+
+    std::vector<cv::Point2f> m_points;
 };
 
 }
@@ -0,0 +1,99 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SOLARDENSEOPTICALFLOWOPENCV_H
+#define SOLARDENSEOPTICALFLOWOPENCV_H
+
+#include "IFrameMotionEstimator.h"
+
+#include "xpcf/component/ConfigurableBase.h"
+#include "SolAROpencvAPI.h"
+
+#include <string>
+#include <vector>
+#include "opencv2/core.hpp"
+#include "opencv2/video/tracking.hpp"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class SolARDenseOpticalFlowOpencv
+ * @brief <B>Estimates the motion and the blur of each frame of a video stream from a dense optical flow at low resolution.</B>
+ * <TT>UUID: be3c1268-11f2-41f9-b50b-6c584d943bf4</TT>
+ *
+ * The frames are converted to grey and downscaled to width pixels. The flow between two consecutive frames is computed by
+ * the Dense Inverse Search of OpenCV, coarse to fine with an inverse search of patches, and its median magnitude is measured
+ * on one pixel out of four. The blur is measured by the variance of the Laplacian, relatively to a maximum over the recent
+ * frames that decreases by sharpnessDecay at each frame, so that it follows the content of the scene.
+ * With the default parameters, a QVGA frame is processed in about a millisecond on one core.
+ *
+ * @SolARComponentPropertiesBegin
+ * @SolARComponentProperty{ width,
+ *                          the width in pixels of the downscaled frames\, the frames are not upscaled,
+ *                          @SolARComponentPropertyDescNum{ int, [16..MAX INT], 320 }}
+ * @SolARComponentProperty{ preset,
+ *                          the preset of the Dense Inverse Search (ULTRAFAST\, FAST\, MEDIUM),
+ *                          @SolARComponentPropertyDescString{ "ULTRAFAST" }}
+ * @SolARComponentProperty{ sharpnessDecay,
+ *                          the factor applied at each frame to the maximum sharpness of the recent frames,
+ *                          @SolARComponentPropertyDescNum{ float, [0..1], 0.95f }}
+ * @SolARComponentPropertiesEnd
+ */
+
+class SOLAROPENCV_EXPORT_API SolARDenseOpticalFlowOpencv : public org::bcom::xpcf::ConfigurableBase,
+        public IFrameMotionEstimator {
+public:
+    SolARDenseOpticalFlowOpencv();
+    ~SolARDenseOpticalFlowOpencv() override = default;
+
+    org::bcom::xpcf::XPCFErrorCode onConfigured() override final;
+
+    /// @brief Estimates the motion between the previous frame and a new frame, and the blur of the new frame.
+    /// @param[in] image: the new frame, grey, RGB or BGR with 8 bits per channel.
+    /// @param[out] medianFlow: the median magnitude of the flow since the previous frame, in pixels of the frame, 0 for the first frame or after a change of size.
+    /// @param[out] blurScore: 1 minus the ratio of the sharpness of the frame to the maximum sharpness of the recent frames.
+    /// @return FrameworkReturnCode::_SUCCESS if the estimation succeeded, else FrameworkReturnCode::_ERROR_
+    FrameworkReturnCode estimate(const SRef<datastructure::Image> image,
+                                 float & medianFlow,
+                                 float & blurScore) override;
+
+    void unloadComponent () override final;
+
+private:
+    int m_width = 320;
+    std::string m_preset = "ULTRAFAST";
+    float m_sharpnessDecay = 0.95f;
+
+    cv::Ptr<cv::DISOpticalFlow> m_flow;
+    float m_maxSharpness = 0.f;
+
+    // buffers kept from one frame to the next, m_previous is the downscaled grey previous frame
+    cv::Mat m_grey;
+    cv::Mat m_previous;
+    cv::Mat m_current;
+    cv::Mat m_flowField;
+    cv::Mat m_laplacian;
+    std::vector<float> m_squaredMagnitudes;
+};
+
+}
+}
+}  // end of namespace Solar
+
+#endif // SOLARDENSEOPTICALFLOWOPENCV_H
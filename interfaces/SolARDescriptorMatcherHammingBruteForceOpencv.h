@@ -49,6 +49,9 @@ namespace OPENCV {
  *                           Several matches can correspond to a given keypoint of the first image. The first match with the best score is always retained.<br>
  *                           But here\, we can also retain the next matches if their distances or scores is greater than the score of the best match * m_distanceRatio.,
  *                         type: float; range : [0..MAX FLOAT]; default: 0.75f}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  * 
  */
@@ -84,6 +87,7 @@ private:
     /// Several matches can correspond to a given keypoint of the first image. The first match with the best score is always retained.
     /// But here, we can also retain the next matches if their distances or scores is greater than the score of the best match * m_distanceRatio.
     float m_distanceRatio = 0.75f;
+    int m_profiling = 0;
 
 
     int m_id;
@@ -55,6 +55,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ matchingDistanceMax,
  *                          ,
  *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 500.f }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  * 
  * 
@@ -112,6 +115,7 @@ private:
 	float m_radius = 5.f;
 
 	float m_matchingDistanceMax = 500.f;
+	int m_profiling = 0;
 
     int m_id;
     cv::FlannBasedMatcher m_matcher;
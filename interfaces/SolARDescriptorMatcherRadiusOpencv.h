@@ -44,6 +44,9 @@ namespace OPENCV {
  *                           Threshold for the distance between matched descriptors.<br>
  *                             Distance means here metric distance (e.g. Hamming distance)\, not the distance between coordinates (which is measured in Pixels),
  *                           @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], default: 1.f }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  * 
  */
@@ -79,6 +82,7 @@ public:
 private:
     /// @brief Threshold for the distance between matched descriptors. Distance means here metric distance (e.g. Hamming distance), not the distance between coordinates (which is measured in Pixels)
     float m_maxDistance = 1.0f;
+    int m_profiling = 0;
 
 
     cv::FlannBasedMatcher m_matcher;
@@ -43,6 +43,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ threshold,
  *                          ,
  *                          @SolARComponentPropertyDescNum{ double, [0..MAX DOUBLE], 3e-4 }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  */
 
@@ -68,6 +71,7 @@ public:
 private:
     cv::Ptr<cv::AKAZE> m_extractor;
     double m_threshold = 3e-4;
+    int m_profiling = 0;
 };
 
 }
@@ -68,6 +68,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ fastThreshold,
  *                          ,
  *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], default: 20 }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * 
  * @SolARComponentPropertiesEnd
  * 
@@ -107,6 +110,7 @@ private:
     std::string m_scoreType = "Harris"; // Accepted values: Harris or Fast
     int m_patchSize = 31;
     int m_fastThreshold = 20;
+    int m_profiling = 0;
 };
 
 }
@@ -19,6 +19,9 @@
 
 #include "api/features/IDescriptorsExtractorSBPattern.h"
 
+#include <vector>
+#include "opencv2/core.hpp"
+
 #include "xpcf/component/ConfigurableBase.h"
 #include "SolAROpencvAPI.h"
 
@@ -56,13 +59,30 @@ public:
 
     void unloadComponent () override final;
 
-private:
-    FrameworkReturnCode getPatternDescriptorFromImage (SRef<datastructure::Image> image, unsigned char* data);
-    bool isPattern(SRef<datastructure::Image> image);
+    /// @brief Checks that the border of a binary patch is black and decodes its inner cells in a single pass over the image.
+    /// @param[in] patch: the 8 bits binary patch, rectified to a square.
+    /// @param[in] patternSize: the number of inner cells in a row of the pattern.
+    /// @param[out] data: the patternSize x patternSize values of the inner cells, row major.
+    /// @param[in,out] cellCounts: a buffer reused from one call to the next.
+    /// @return true if the patch has a black border.
+    static bool decodePattern(const cv::Mat & patch, int patternSize, unsigned char* data, std::vector<int> & cellCounts);
+
+    /// @brief Writes the descriptors of a decoded pattern and of its three 90° counter-clockwise rotations, and the matching rotated contours.
+    /// @param[in] pattern: the decoded pattern, patternSize x patternSize values.
+    /// @param[in] patternSize: the number of inner cells in a row of the pattern.
+    /// @param[in] contour: the four corners of the pattern in the image.
+    /// @param[out] data: the four descriptors, 4 x patternSize x patternSize values.
+    /// @param[in,out] recognized_contours: the four rotated contours are appended to it.
+    static void addPattern(const unsigned char* pattern, int patternSize, const datastructure::Contour2Df & contour,
+                           unsigned char* data, std::vector<datastructure::Contour2Df> & recognized_contours);
 
 private:
     // Define the internal size of the pattern (without the black border)
     int m_patternSize = 5;
+
+    // buffers reused from one extraction to the next
+    std::vector<unsigned char> m_patterns;
+    std::vector<int> m_cellCounts;
 };
 
 }
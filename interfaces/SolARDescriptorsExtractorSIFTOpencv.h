@@ -62,6 +62,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ m_sigma,
  *                          ,
  *                          @SolARComponentPropertyDescNum{ double, [0..MAX DOUBLE], 1.6 }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  */
 
@@ -88,6 +91,7 @@ private:
     double m_contrastThreshold = 0.04;
     double m_edgeThreshold = 10.0;
     double m_sigma = 1.6;
+    int m_profiling = 0;
 };
 
 }
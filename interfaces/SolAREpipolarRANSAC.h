@@ -0,0 +1,100 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOLAREPIPOLARRANSAC_H
+#define SOLAREPIPOLARRANSAC_H
+
+#include <vector>
+#include <cstdint>
+#include <Eigen/Core>
+
+#include "SolAROpencvAPI.h"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @struct EpipolarCorrespondences
+ * @brief Matched 2D points of two views stored as a structure of arrays, the i-th point of each array belonging to the i-th correspondence.
+ */
+struct EpipolarCorrespondences {
+    std::vector<float> x1;
+    std::vector<float> y1;
+    std::vector<float> x2;
+    std::vector<float> y2;
+
+    void reserve(size_t size) { x1.reserve(size); y1.reserve(size); x2.reserve(size); y2.reserve(size); }
+    void clear() { x1.clear(); y1.clear(); x2.clear(); y2.clear(); }
+    void push_back(float px1, float py1, float px2, float py2) { x1.push_back(px1); y1.push_back(py1); x2.push_back(px2); y2.push_back(py2); }
+    size_t size() const { return x1.size(); }
+};
+
+/**
+ * @class SolAREpipolarRANSAC
+ * @brief A robust estimator of the fundamental or essential matrix between two views.
+ *
+ * Minimal models are computed with the 7-point solver (fundamental matrix) or the 5-point solver of Stewenius (essential matrix),
+ * scored with a truncated Sampson error (MSAC), and every new best model is refined by iterative least squares on its inliers (LO-RANSAC).
+ * The number of iterations adapts to the inlier ratio of the best model.
+ * The correspondences of an essential matrix estimation must be normalized with the camera intrinsics.
+ */
+class SOLAROPENCV_EXPORT_API SolAREpipolarRANSAC {
+public:
+    enum class Model {
+        FUNDAMENTAL,    ///< 7-point minimal solver, rank 2 matrix
+        ESSENTIAL       ///< 5-point minimal solver, normalized correspondences
+    };
+
+    /// @brief SolAREpipolarRANSAC constructor.
+    /// @param[in] model: the kind of matrix to estimate.
+    /// @param[in] threshold: the maximum Sampson distance of an inlier, in the unit of the correspondences.
+    /// @param[in] confidence: the desirable level of confidence (probability) that the estimated matrix is correct.
+    /// @param[in] maxIterations: the maximum number of sampling iterations.
+    SolAREpipolarRANSAC(Model model, float threshold, float confidence, int maxIterations = 1000);
+
+    /// @brief Estimates the matrix M such that [x2 y2 1] M [x1 y1 1]' = 0 for the inlier correspondences.
+    /// @param[in] correspondences: the matched points of the two views.
+    /// @param[out] matrix: the estimated matrix.
+    /// @param[out] inliers: one flag per correspondence, set to 1 for inliers.
+    /// @return true if a matrix has been found.
+    bool estimate(const EpipolarCorrespondences & correspondences, Eigen::Matrix3d & matrix, std::vector<uint8_t> & inliers) const;
+
+    /// @brief Computes the squared Sampson distances of the correspondences to a matrix.
+    /// @param[in] matrix: the epipolar matrix.
+    /// @param[in] correspondences: the matched points of the two views.
+    /// @param[in] threshold2: the squared threshold used to truncate the errors and count the inliers.
+    /// @param[out] errors: the squared Sampson distance of each correspondence, can be null.
+    /// @param[out] score: the sum of the errors truncated to threshold2 (the lower, the better).
+    /// @return the number of correspondences whose error is lower than threshold2.
+    static int scoreSampson(const Eigen::Matrix3d & matrix, const EpipolarCorrespondences & correspondences, float threshold2, float * errors, float & score);
+
+private:
+    int solveMinimal(const EpipolarCorrespondences & correspondences, const int * sample, std::vector<Eigen::Matrix3d> & models) const;
+    bool solveLeastSquares(const EpipolarCorrespondences & correspondences, const std::vector<int> & indices, Eigen::Matrix3d & model) const;
+    void localOptimization(const EpipolarCorrespondences & correspondences, Eigen::Matrix3d & model, float & score, int & nbInliers, std::vector<float> & errors) const;
+
+    Model m_model;
+    float m_threshold;
+    float m_confidence;
+    int m_maxIterations;
+};
+
+}
+}
+}
+
+#endif // SOLAREPIPOLARRANSAC_H
@@ -0,0 +1,57 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOLARFASTGAUSSIAN_H
+#define SOLARFASTGAUSSIAN_H
+
+#include <vector>
+#include "opencv2/core.hpp"
+
+#include "SolAROpencvAPI.h"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class SolARFastGaussian
+ * @brief Approximates a Gaussian smoothing by three successive box filters, whose cost does not depend on the standard deviation.
+ *
+ * The widths of the boxes are chosen so that their successive application has the variance of the Gaussian. CV_8U images are
+ * filtered in fixed point on 16 bits with 8 fractional bits, CV_32F images in floating point, and bands of rows are filtered in parallel.
+ * The standard deviation of the approximation is within 10% of the requested one from 2 and within 5% from 3 pixels,
+ * below 2 pixels in either direction the Gaussian kernel of the requested size is applied, as cv::GaussianBlur does.
+ */
+class SOLAROPENCV_EXPORT_API SolARFastGaussian {
+public:
+    /// @brief Smooths an image, with the same parameters as cv::GaussianBlur.
+    /// @param[in] src: the image, CV_8U or CV_32F with any number of channels.
+    /// @param[out] dst: the smoothed image, with the size and the type of src, can be src.
+    /// @param[in] ksize: the size of the Gaussian kernel applied below 2 pixels, computed from the standard deviations if null.
+    /// @param[in] sigmaX: the horizontal standard deviation of the Gaussian, in pixels.
+    /// @param[in] sigmaY: the vertical standard deviation of the Gaussian, in pixels, sigmaX if null.
+    /// @param[in] borderType: the extrapolation of the border, see cv::BorderTypes.
+    static void blur(const cv::Mat & src, cv::Mat & dst, cv::Size ksize, float sigmaX, float sigmaY = 0.f, int borderType = cv::BORDER_DEFAULT);
+
+    /// @brief Computes the odd widths of nbBoxes box filters whose successive application has the variance of a Gaussian of standard deviation sigma.
+    static void boxWidths(float sigma, int nbBoxes, std::vector<int> & widths);
+};
+
+}
+}
+}
+
+#endif // SOLARFASTGAUSSIAN_H
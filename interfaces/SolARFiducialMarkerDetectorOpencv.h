@@ -0,0 +1,138 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOLARFIDUCIALMARKERDETECTOROPENCV_H
+#define SOLARFIDUCIALMARKERDETECTOROPENCV_H
+
+#include "IFiducialMarkerDetector.h"
+
+#include "xpcf/component/ConfigurableBase.h"
+#include "SolAROpencvAPI.h"
+
+#include "opencv2/core.hpp"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class SolARFiducialMarkerDetectorOpencv
+ * @brief <B>Detects the squared binary markers of an image in a single component.</B>
+ * <TT>UUID: 9a277889-a2d7-4ba5-a542-027bd0eb7b6a</TT>
+ *
+ * Fuses the adaptive binarization, the contours extraction and filtering, the perspective correction and the pattern decoding.
+ * The intermediate buffers are kept from one frame to the next, the candidates are rejected on their size and their shape
+ * before any warp, and only small patches of cellSize pixels per cell are rectified from the binary image.
+ * The outputs are the ones of the chain configured with the same parameters and a patch of (patternSize + 2) x cellSize pixels.
+ * In tracking mode, the binarization and the contours extraction are restricted to the bounding box of the markers recognized
+ * in the previous frame, expanded by roiMargin. The whole frame is searched when no marker is recognized in this region
+ * and every fullScanInterval frames.
+ *
+ * @SolARComponentPropertiesBegin
+ * @SolARComponentProperty{ blockSize,
+ *                          the size of the pixel neighborhood used to compute the adaptive threshold,
+ *                          @SolARComponentPropertyDescNum{ int, [3..MAX INT], 11 }}
+ * @SolARComponentProperty{ C,
+ *                          the constant subtracted from the mean of the neighborhood,
+ *                          @SolARComponentPropertyDescNum{ int, [MIN INT..MAX INT], 2 }}
+ * @SolARComponentProperty{ minContourEdges,
+ *                          the minimum number of edges of a contour to keep it as a candidate,
+ *                          @SolARComponentPropertyDescNum{ int, [-1..MAX INT], 4 }}
+ * @SolARComponentProperty{ epsilon,
+ *                          the maximum distance between a contour and its approximation relatively to the number of points of the contour,
+ *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 0.05f }}
+ * @SolARComponentProperty{ minContourLength,
+ *                          the minimum length of an edge of a simplified contour,
+ *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 20.f }}
+ * @SolARComponentProperty{ minDistanceBetweenContourCorners,
+ *                          the minimum average distance in pixels between the corners of two candidates\, the candidate with the lower perimeter is removed,
+ *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 10.f }}
+ * @SolARComponentProperty{ patternSize,
+ *                          the internal size of the pattern (without the black border),
+ *                          @SolARComponentPropertyDescNum{ int, [1..MAX INT], 5 }}
+ * @SolARComponentProperty{ cellSize,
+ *                          the size in pixels of a cell of the rectified patch,
+ *                          @SolARComponentPropertyDescNum{ int, [1..MAX INT], 8 }}
+ * @SolARComponentProperty{ tracking,
+ *                          if not null\, the markers are searched around the markers of the previous frame only,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
+ * @SolARComponentProperty{ roiMargin,
+ *                          the margin added around the markers of the previous frame\, relatively to the size of their bounding box,
+ *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 0.5f }}
+ * @SolARComponentProperty{ fullScanInterval,
+ *                          the maximum number of tracked frames between two searches in the whole frame,
+ *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], 30 }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
+ * @SolARComponentPropertiesEnd
+ */
+
+class SOLAROPENCV_EXPORT_API SolARFiducialMarkerDetectorOpencv : public org::bcom::xpcf::ConfigurableBase,
+        public IFiducialMarkerDetector {
+public:
+    SolARFiducialMarkerDetectorOpencv();
+    ~SolARFiducialMarkerDetectorOpencv() override = default;
+
+    /// @brief Detects the squared binary markers of an image.
+    /// @param[in] image: the input image, grey, RGB or BGR.
+    /// @param[out] descriptors: for each recognized marker, the descriptors of its pattern and of its three 90° counter-clockwise rotations.
+    /// @param[out] contours: the four corners of each recognized marker, one contour per descriptor.
+    /// @return FrameworkReturnCode::_SUCCESS if the detection succeeded, else FrameworkReturnCode::_ERROR_
+    FrameworkReturnCode detect(const SRef<datastructure::Image> image,
+                               SRef<datastructure::DescriptorBuffer> & descriptors,
+                               std::vector<datastructure::Contour2Df> & contours) override;
+
+    void unloadComponent () override final;
+
+private:
+    /// @brief Detects the markers in a region of the grey image, fills m_markers with their corners in the frame, m_recognized and m_patterns.
+    void detectInRegion(const cv::Mat & grey, const cv::Rect & region);
+
+    int m_blockSize = 11;
+    int m_C = 2;
+    int m_minContourEdges = 4;
+    float m_epsilon = 0.05f;
+    float m_minContourLength = 20.0f;
+    float m_minDistanceBetweenContourCorners = 10.0f;
+    int m_patternSize = 5;
+    int m_cellSize = 8;
+    int m_tracking = 0;
+    float m_roiMargin = 0.5f;
+    int m_fullScanInterval = 30;
+    int m_profiling = 0;
+
+    // tracking state
+    cv::Rect m_trackedRegion;
+    int m_nbFramesSinceFullScan = 0;
+
+    // buffers kept from one frame to the next
+    cv::Mat m_grey;
+    cv::Mat m_binary;
+    cv::Mat m_patch;
+    std::vector<std::vector<cv::Point>> m_contours;
+    std::vector<datastructure::Contour2Df> m_candidates;
+    std::vector<datastructure::Contour2Df> m_markers;
+    std::vector<size_t> m_recognized;
+    std::vector<unsigned char> m_patterns;
+    std::vector<int> m_cellCounts;
+};
+
+}
+}
+}  // end of namespace Solar
+
+#endif // SOLARFIDUCIALMARKERDETECTOROPENCV_H
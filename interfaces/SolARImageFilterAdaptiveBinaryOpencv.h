@@ -36,6 +36,9 @@ namespace OPENCV {
  * @brief <B>Filters a greyscale image to a binary image based on an adaptive threshold.</B>
  * <TT>UUID: 901e7a07-5013-4907-be41-0259fca3726c</TT>
  *
+ * The mean of the neighborhood and the threshold are computed in a single pass over bands of rows processed in parallel,
+ * with the output of cv::adaptiveThreshold with ADAPTIVE_THRESH_MEAN_C and THRESH_BINARY. The output image is reused from one frame to the next.
+ *
  * @SolARComponentPropertiesBegin
  * @SolARComponentProperty{ max,
  *                          Non - zero value assigned to the pixels for which the condition is satisfied,
@@ -48,6 +51,9 @@ namespace OPENCV {
  *                          Constant subtracted from the mean or weighted mean(see the details below).Normally\, it<br>
  *                            is positive but may be zero or negative as well.,
  *                          @SolARComponentPropertyDescNum{ int, [MIN INT..MAX INT], 2 }}
+ * @SolARComponentProperty{ meanScale,
+ *                          if greater than 1\, the mean is approximated on the image downscaled by this factor,
+ *                          @SolARComponentPropertyDescNum{ int, [1..MAX INT], 1 }}
  * @SolARComponentPropertiesEnd
  * 
  */
@@ -63,10 +69,23 @@ public:
 
     void unloadComponent () override final;
 
+    /// @brief Thresholds a CV_8UC1 image like cv::adaptiveThreshold with ADAPTIVE_THRESH_MEAN_C and THRESH_BINARY, in a single pass.
+    /// @param[in] src: the grey image.
+    /// @param[out] dst: the binary image, allocated if needed, it must not share its data with src.
+    static void adaptiveThreshold(const cv::Mat & src, cv::Mat & dst, int maxValue, int blockSize, int C);
+
  private:
+    /// @brief Thresholds against the mean of the neighborhood computed on the image downscaled by scale.
+    void adaptiveThresholdDownscaled(const cv::Mat & src, cv::Mat & dst, int maxValue, int blockSize, int C, int scale);
+
     int m_max = 255;
     int m_blockSize = 11;
     int m_C = 2;
+    int m_meanScale = 1;
+
+    cv::Mat m_source;
+    cv::Mat m_small;
+    cv::Mat m_smallMean;
 };
 
 }
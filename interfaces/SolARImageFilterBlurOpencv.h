@@ -48,7 +48,7 @@ namespace OPENCV {
  *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], 0 }}
  * @SolARComponentProperty{ direction,
  *                          ,
- *                          @SolARComponentPropertyDescNum{ int, [0 (Homogeneous blurring)\, 1 (Gaussian blurring)\, 2 (Median blurring)\, 3 (Bilateral blurring)\, 4 (Bilateral blurring)], 0 }}
+ *                          @SolARComponentPropertyDescNum{ int, [0 (Homogeneous blurring)\, 1 (Gaussian blurring)\, 2 (Median blurring)\, 3 (Bilateral blurring)\, 4 (Fast Gaussian blurring with box filters\, for CV_8U and CV_32F images)], 0 }}
  * 
  * @SolARComponentPropertiesEnd
  */
@@ -69,6 +69,8 @@ public:
     int kernel_height;
     int direction;
 
+    cv::Mat m_source;
+
 };
 }
 }
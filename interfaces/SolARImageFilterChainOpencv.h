@@ -0,0 +1,101 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOLARIMAGEFILTERCHAINOPENCV_H
+#define SOLARIMAGEFILTERCHAINOPENCV_H
+
+#include "api/image/IImageFilter.h"
+#include "xpcf/component/ConfigurableBase.h"
+#include "SolAROpencvAPI.h"
+
+#include "opencv2/core.hpp"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class SolARImageFilterChainOpencv
+ * @brief <B>Blurs, binarizes, erodes and dilates a greyscale image in a single pass over bands of rows.</B>
+ * <TT>UUID: 9a4d14bf-6267-4142-99c7-e29cb30e67f6</TT>
+ *
+ * The output is the one of the chain SolARImageFilterBlurOpencv (homogeneous blurring), SolARImageFilterBinaryOpencv,
+ * SolARImageFilterErodeOpencv and SolARImageFilterDilateOpencv configured with the same properties. Each band of tileHeight rows
+ * goes through all the filters while it is in cache, with the few rows above and below required by the morphological operations,
+ * and the bands are processed in parallel. A step is skipped when its kernel size is null.
+ *
+ * @SolARComponentPropertiesBegin
+ * @SolARComponentProperty{ kernel_width,
+ *                          the width of the blur kernel\, no blur if null,
+ *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], 0 }}
+ * @SolARComponentProperty{ kernel_height,
+ *                          the height of the blur kernel\, no blur if null,
+ *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], 0 }}
+ * @SolARComponentProperty{ min,
+ *                          the threshold of the binarization,
+ *                          @SolARComponentPropertyDescNum{ int, [0..255], 128 }}
+ * @SolARComponentProperty{ max,
+ *                          the value of the pixels above the threshold,
+ *                          @SolARComponentPropertyDescNum{ int, [0..255], 255 }}
+ * @SolARComponentProperty{ erosion_elem,
+ *                          See cv::MorphShapes,
+ *                          @SolARComponentPropertyDescNum{ int, [0 (cv::MORPH_RECT)\, 1 (cv::MORPH_CROSS)\, 2 (cv::MORPH_ELLIPSE)], 0 }}
+ * @SolARComponentProperty{ erosion_size,
+ *                          the radius of the erosion\, no erosion if null,
+ *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], 0 }}
+ * @SolARComponentProperty{ dilate_elem,
+ *                          See cv::MorphShapes,
+ *                          @SolARComponentPropertyDescNum{ int, [0 (cv::MORPH_RECT)\, 1 (cv::MORPH_CROSS)\, 2 (cv::MORPH_ELLIPSE)], 0 }}
+ * @SolARComponentProperty{ dilate_size,
+ *                          the radius of the dilation\, no dilation if null,
+ *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], 0 }}
+ * @SolARComponentProperty{ tileHeight,
+ *                          the number of rows of a band,
+ *                          @SolARComponentPropertyDescNum{ int, [1..MAX INT], 32 }}
+ * @SolARComponentPropertiesEnd
+ */
+
+class SOLAROPENCV_EXPORT_API SolARImageFilterChainOpencv : public org::bcom::xpcf::ConfigurableBase,
+        public api::image::IImageFilter {
+public:
+
+    SolARImageFilterChainOpencv();
+    ~SolARImageFilterChainOpencv() override = default;
+
+    /// @brief Filters a greyscale image, output is reused when it has the size of input and can be input.
+    FrameworkReturnCode filter(const SRef<datastructure::Image>input, SRef<datastructure::Image>& output) override;
+
+    void unloadComponent () override final;
+
+ private:
+    int m_kernelWidth = 0;
+    int m_kernelHeight = 0;
+    int m_min = 128;
+    int m_max = 255;
+    int m_erosionElem = 0;
+    int m_erosionSize = 0;
+    int m_dilateElem = 0;
+    int m_dilateSize = 0;
+    int m_tileHeight = 32;
+
+    cv::Mat m_source;
+};
+
+}
+}
+}
+
+#endif // SOLARIMAGEFILTERCHAINOPENCV_H
@@ -61,6 +61,8 @@ public:
 
  private:
     int dilate_elem, dilate_size;
+
+    cv::Mat m_source;
 };
 
 }
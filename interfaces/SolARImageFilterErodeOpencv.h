@@ -60,6 +60,8 @@ public:
 
  private:
     int erosion_elem, erosion_size;
+
+    cv::Mat m_source;
 };
 
 }
@@ -18,10 +18,17 @@
 #define SOLARIMAGEVIEWEROPENCV_H
 
 #include "api/display/IImageViewer.h"
+#include "IImageRecorder.h"
 
 #include "xpcf/component/ConfigurableBase.h"
 #include "SolAROpencvAPI.h"
+#include <atomic>
+#include <chrono>
+#include <mutex>
 #include <string>
+#include <thread>
+
+#include "opencv2/core.hpp"
 
 namespace SolAR {
 namespace MODULES {
@@ -48,7 +55,26 @@ namespace OPENCV {
  * @SolARComponentProperty{ duration,
  *                          The duration in milliseconds before closing the window. If negative or null\, the window remains open,
  *                          @SolARComponentPropertyDescNum{ uint, [0..MAX UINT], 0 }}
+ * @SolARComponentProperty{ asynchronous,
+ *                          if not null\, the images are displayed by a dedicated thread and display returns without waiting (ignored by the WINDOW backend on macOS),
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
+ * @SolARComponentProperty{ backend,
+ *                          WINDOW displays the images\, RECORD encodes them into recordFile in the background\, NULL drops them (values among [\"WINDOW\"\, \"RECORD\"\, \"NULL\"]),
+ *                          @SolARComponentPropertyDescString{ "WINDOW" }}
+ * @SolARComponentProperty{ recordFile,
+ *                          the path of the video file written by the RECORD backend (the images are dropped if empty),
+ *                          @SolARComponentPropertyDescString{ "" }}
+ * @SolARComponentProperty{ recordFrameRate,
+ *                          the frame rate of the video file written by the RECORD backend,
+ *                          @SolARComponentPropertyDescNum{ float, ]0..MAX FLOAT], 30.f }}
  * @SolARComponentPropertiesEnd
+ *
+ * In asynchronous mode, the images are copied into a mailbox where the latest one replaces the one not displayed yet,
+ * and the display thread shows them at its own rate. displayKey returns the last key pressed since the previous call
+ * and duration is not waited. The RECORD backend records the images with SolARVideoRecorderOpencv in the VIDEO format with the MJPG codec,
+ * its queue of one image keeps the latest one when the encoder is late, and a recording stops at the first image of another size.
+ * HighGUI windows must be handled by the main thread on macOS (Cocoa), so the asynchronous mode of the WINDOW backend
+ * is ignored there with a warning and the images are displayed synchronously.
  */
 
 class SOLAROPENCV_EXPORT_API SolARImageViewerOpencv : public org::bcom::xpcf::ConfigurableBase,
@@ -85,7 +111,39 @@ private:
     /// @brief The duration in milliseconds before closing the window. If negative or null, the window remains open.
     unsigned int m_duration = 0;
 
+    /// @brief If not null, the images are displayed by a dedicated thread and display returns without waiting.
+    int m_asynchronous = 0;
+
+    /// @brief WINDOW displays the images, RECORD encodes them into m_recordFile in the background, NULL drops them.
+    std::string m_backend = "WINDOW";
+
+    /// @brief The path of the video file written by the RECORD backend.
+    std::string m_recordFile = "";
+
+    /// @brief The frame rate of the video file written by the RECORD backend.
+    float m_recordFrameRate = 30.f;
+
     bool m_isFirstDisplay = true;
+    int m_backendId = -1;
+
+    /// @brief Shows an image in the window, resized at the first display, and returns the key pressed.
+    char show(const cv::Mat & image, int delay);
+
+    void displayLoop();
+    void stopDisplayThread();
+
+    // latest-wins mailbox between the caller and the display thread
+    std::thread m_displayThread;
+    std::mutex m_mailboxMutex;
+    cv::Mat m_backFrame;
+    cv::Mat m_mailboxFrame;
+    bool m_hasNewFrame = false;
+    bool m_stopDisplay = false;
+    std::atomic<char> m_lastKey{0};
+
+    // encoder of the RECORD backend
+    SRef<IImageRecorder> m_recorder;
+    std::chrono::steady_clock::time_point m_recordStart;
 };
 
 }
@@ -59,6 +59,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ type,
  *                          type of descriptor used for the extraction (SIFT\, AKAZE\, AKAZE2\, ORB\, BRISK),
  *                          @SolARComponentPropertyDescString{ "AKAZE2" }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  */
 
@@ -102,6 +105,8 @@ private:
 	/// @brief the threshold of detector to accept a keypoint
     float m_threshold = 1e-3f;
 
+    int m_profiling = 0;
+
     int m_id;
     cv::Ptr<cv::Feature2D> m_detector;
     cv::KeyPointsFilter kptsFilter;
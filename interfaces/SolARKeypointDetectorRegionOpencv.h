@@ -40,6 +40,10 @@ namespace OPENCV {
  * @brief <B>Detects keypoints in an given region of an image.</B>
  * <TT>UUID: 22c2ca9f-e43b-4a88-8337-4a166a789971</TT>
  *
+ * The keypoints are detected in the bounding box of the region only, expanded by a margin of 32 pixels at the detection scale,
+ * with a mask of the region. The keypoints close to its edges are then tested exactly against the polygon.
+ * The nbDescriptors best keypoints are selected inside the region.
+ *
  * @SolARComponentPropertiesBegin
  * @SolARComponentProperty{ imageRatio,
  *                          the ratio to apply to the size of the input image to compute the descriptor.<br>
@@ -51,6 +55,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ threshold,
  *                          the threshold of detector to accept a keypoint,
  *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 1e-3f }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  * 
  */
@@ -88,6 +95,7 @@ public:
 private:
     /// @brief the type of descriptor used for the extraction (AKAZE, AKAZE2, ORB, BRISK)
     std::string m_type = "AKAZE2";
+    int m_profiling = 0;
 
     /// @brief the ratio to apply to the size of the input image to compute the descriptor.
     /// A ratio must be less or equal to 1. A ratio less than 1 will speedup computation
@@ -103,6 +111,13 @@ private:
     cv::Ptr<cv::Feature2D> m_detector;
     cv::KeyPointsFilter kptsFilter;
 
+    // buffers kept from one frame to the next
+    std::vector<cv::Point2f> m_polygon;
+    std::vector<cv::Point> m_maskPolygon;
+    cv::Mat m_grey;
+    cv::Mat m_resized;
+    cv::Mat m_mask;
+
 };
 
 extern int deduceOpenCVType(SRef<datastructure::Image> img);
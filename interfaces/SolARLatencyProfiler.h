@@ -0,0 +1,93 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SOLARLATENCYPROFILER_H
+#define SOLARLATENCYPROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "SolAROpencvAPI.h"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class SolARLatencyProfiler
+ * @brief Records the latency of the calls to the components of the module, per component and per method.
+ *
+ * Each thread records into its own histograms without any lock: 8 sub-buckets per power of two of nanoseconds,
+ * so the percentiles are known within 6%. The histograms of a thread are kept when it ends and reused by the next thread.
+ * The histograms of all the threads are merged by name when they are dumped. They can be dumped or reset while calls are
+ * recorded, a call recorded meanwhile may then be partially counted.
+ * The calls of a component are recorded when its profiling property is set, or for all the components when the profiler is enabled.
+ */
+class SOLAROPENCV_EXPORT_API SolARLatencyProfiler {
+public:
+    /// @brief Enables the recording of the calls of all the instrumented components, whatever their profiling property.
+    static void setEnabled(bool enabled);
+
+    /// @brief Returns true if the calls of all the instrumented components are recorded.
+    static bool isEnabled();
+
+    /// @brief Records a call in the histograms of the calling thread.
+    /// @param[in] name: the name of the call, a string literal, at most 64 names are recorded per thread.
+    /// @param[in] nanoseconds: the duration of the call.
+    static void record(const char * name, uint64_t nanoseconds);
+
+    /// @brief Returns the statistics of the recorded calls as a JSON object sorted by name:
+    /// for each name, the number of calls and the mean, 50th, 95th and 99th percentiles and maximum durations in milliseconds.
+    static std::string toJSON();
+
+    /// @brief Clears the statistics of all the threads.
+    static void reset();
+};
+
+/**
+ * @class SolARScopedTimer
+ * @brief Records the time spent in its scope in SolARLatencyProfiler, when enabled or when the profiler is enabled.
+ */
+class SolARScopedTimer {
+public:
+    SolARScopedTimer(const char * name, bool enabled) : m_name((enabled || SolARLatencyProfiler::isEnabled()) ? name : nullptr)
+    {
+        if (m_name)
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~SolARScopedTimer()
+    {
+        if (m_name)
+            SolARLatencyProfiler::record(m_name, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                     std::chrono::steady_clock::now() - m_start).count()));
+    }
+
+    SolARScopedTimer(const SolARScopedTimer &) = delete;
+    SolARScopedTimer & operator=(const SolARScopedTimer &) = delete;
+
+private:
+    const char * m_name;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}
+}
+}
+
+#endif // SOLARLATENCYPROFILER_H
@@ -41,14 +41,23 @@ namespace OPENCV {
 *
 * @SolARComponentInjectablesBegin
 * @SolARComponentInjectable{SolAR::api::geom::I3DTransform}
-* @SolARComponentInjectable{SolAR::api::features::IDescriptorMatcher}
 * @SolARComponentInjectable{SolAR::api::solver::pose::I3DTransformSACFinderFrom3D3D}
+* @SolARComponentInjectable{SolAR::api::features::IDescriptorMatcher}
 * @SolARComponentInjectablesEnd
+*
+* The descriptor matcher is optional and no longer used: the descriptor distances are computed in the module so that
+* the duplicates are searched concurrently. It is still accepted so that the existing configurations keep loading.
 * 
 * @SolARComponentPropertiesBegin
 * @SolARComponentProperty{ radius,
 *                          ,
 *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 0.3f }}
+* @SolARComponentProperty{ distanceRatio,
+*                          ratio between the best and the second best descriptor distances for a duplicate to be accepted,
+*                          @SolARComponentPropertyDescNum{ float, [0..1], 0.75f }}
+* @SolARComponentProperty{ profiling,
+*                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+*                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
 * @SolARComponentPropertiesEnd
 */
 
@@ -88,6 +97,25 @@ public:
 
 	void unloadComponent() override final;
 
+	/// @brief Find the duplicates of a point cloud in a global point cloud.
+	/// Candidates are searched concurrently for each point, then a global point claimed by several points is kept for the best descriptor distance, so the result does not depend on the number of threads.
+	/// @param[in] points: positions of the points to match (N x 3, CV_32F).
+	/// @param[in] descriptors: descriptors of the points to match, one row per point (CV_8U compared with Hamming distance, CV_32F with L2 distance).
+	/// @param[in] globalPoints: positions of the global points (M x 3, CV_32F).
+	/// @param[in] globalDescriptors: descriptors of the global points, one row per point.
+	/// @param[in] radius: radius of the kd-tree search.
+	/// @param[in] distanceRatio: ratio between the best and the second best descriptor distances for a duplicate to be accepted.
+	/// @param[out] duplicatedIndices: pairs of row indices of duplicated points, first in points, second in globalPoints, sorted by the first index.
+	/// @param[in] exactSearch: if true, the neighbors of each point are searched exhaustively in a single kd-tree instead of approximately in randomized kd-trees, so the result does not depend on the tree construction either.
+	static void findDuplicates(const cv::Mat & points,
+							   const cv::Mat & descriptors,
+							   const cv::Mat & globalPoints,
+							   const cv::Mat & globalDescriptors,
+							   float radius,
+							   float distanceRatio,
+							   std::vector<std::pair<uint32_t, uint32_t>> & duplicatedIndices,
+							   bool exactSearch = false);
+
 private:
 	/// @brief fuse a map into the global map.
 	/// @param[in] cpOverlapIndices : pairs of detected overlap cloud points indices of floating map and global map.
@@ -97,9 +125,11 @@ private:
 
 private:
     float													m_radius = 0.3f;
+	float													m_distanceRatio = 0.75f;
+	int													m_profiling = 0;
 	SRef<api::geom::I3DTransform>							m_transform3D;
-	SRef<api::features::IDescriptorMatcher>					m_matcher;
 	SRef<api::solver::pose::I3DTransformSACFinderFrom3D3D>	m_estimator3D;
+	SRef<api::features::IDescriptorMatcher>					m_matcher;
 };
 
 }
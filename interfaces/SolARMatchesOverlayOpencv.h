@@ -34,6 +34,9 @@ namespace OPENCV {
  * @brief <B>Displays matching keypoints between two images.</B>
  * <TT>UUID: e95302be-3fe1-44e0-97bf-a98380464af9</TT>
  *
+ * All the overloads share a single rendering pass. The output image is reused when its size does not change,
+ * and the colors of the RANDOM and FADING modes are taken from palettes computed once.
+ *
  * @SolARComponentPropertiesBegin
  * @SolARComponentProperty{ thickness,
  *                          thickness of the lines displaying the matches between the two images,
@@ -47,6 +50,12 @@ namespace OPENCV {
  * @SolARComponentProperty{ maxMatches,
  *                          the maximum number of matches to display. If negative\, all matches are displayed,
  *                          @SolARComponentPropertyDescNum{ int, [-1..MAX INT], -1 }}
+ * @SolARComponentProperty{ lodStep,
+ *                          only one match out of lodStep is drawn,
+ *                          @SolARComponentPropertyDescNum{ int, [1..MAX INT], 1 }}
+ * @SolARComponentProperty{ previewScale,
+ *                          if lower than 1\, the images and the matches are drawn in an output image downscaled by this factor,
+ *                          @SolARComponentPropertyDescNum{ float, ]0..1], 1.f }}
  * @SolARComponentPropertiesEnd
  * 
  */
@@ -99,6 +108,18 @@ public:
     void unloadComponent () override final;
 
 private:
+    /// @brief Sizes the output image and copies the images into it, side-by-side when image2 is not null.
+    cv::Mat prepareCanvas(const SRef<datastructure::Image> & image1, const SRef<datastructure::Image> & image2, SRef<datastructure::Image> & outImage) const;
+
+    /// @brief Draws the matches in the canvas, the second points being shifted by offset pixels of the canvas.
+    /// normalization1 and normalization2 convert the points into the distance ratios of the FADING mode.
+    template <class T>
+    void drawMatches(cv::Mat & canvas, const std::vector<T> & points1, const std::vector<T> & points2, const std::vector<datastructure::DescriptorMatch> & matches,
+                     float offset, float normalization1, float normalization2) const;
+
+    /// @brief Returns the scale of the output image relatively to the input images.
+    float getScale() const;
+
     /// @brief The color of the linse displaying the matches between the two images
     std::vector<unsigned int> m_color = {0,255,0};
 
@@ -113,6 +134,15 @@ private:
 
     /// @brief the minimal distance ratio compared to the image width for which the line will be green. Otherwise, the color will be red if the distance ratio of a matche is null, and will fade to yellow and then to green green when the distance ratio of a match will be equal to this value (used only for FADING mode).
     float m_minDistanceRatioGreen = 0.15f;
+
+    /// @brief only one match out of m_lodStep is drawn
+    int m_lodStep = 1;
+
+    /// @brief if lower than 1, the output image is downscaled by this factor
+    float m_previewScale = 1.f;
+
+    std::vector<cv::Scalar> m_randomPalette;
+    std::vector<cv::Scalar> m_fadingPalette;
 };
 
 }
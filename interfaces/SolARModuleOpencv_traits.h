@@ -42,6 +42,7 @@ class SolARDescriptorsExtractorAKAZE2Opencv;
 class SolARDescriptorsExtractorAKAZEOpencv;
 class SolARDescriptorsExtractorORBOpencv;
 class SolARDescriptorsExtractorSBPatternOpencv;
+class SolARFiducialMarkerDetectorOpencv;
 class SolARFiducialMarkerLoaderOpencv;
 class SolARFundamentalMatrixEstimationOpencv;
 class SolARGeometricMatchesFilterOpencv;
@@ -52,6 +53,7 @@ class SolARImageConvertorUnity;
 class SolARImageFilterBinaryOpencv;
 class SolARImageFilterAdaptiveBinaryOpencv;
 class SolARImageFilterBlurOpencv;
+class SolARImageFilterChainOpencv;
 class SolARImageFilterDilateOpencv;
 class SolARImageFilterErodeOpencv;
 class SolARImageLoaderOpencv;
@@ -63,6 +65,7 @@ class SolARMarker2DNaturalImageOpencv;
 class SolARMarker2DSquaredBinaryOpencv;
 class SolARMatchesOverlayOpencv;
 class SolAROpticalFlowPyrLKOpencv;
+class SolARDenseOpticalFlowOpencv;
 class SolARPerspectiveControllerOpencv;
 class SolARProjectOpencv;
 class SolARUnprojectPlanarPointsOpencv;
@@ -75,6 +78,7 @@ class SolARSVDTriangulationOpencv;
 class SolAR2D3DCorrespondencesFinderOpencv;
 class SolARUndistortPointsOpencv;
 class SolARVideoAsCameraOpencv;
+class SolARVideoRecorderOpencv;
 class SolARDeviceDataLoader;
 class SolARMapFusionOpencv;
 }
@@ -156,6 +160,11 @@ XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARDescriptorsExtractorSB
                              "SolARDescriptorsExtractorSBPatternOpencv",
                              "Extracts the descriptor corresponding to a squared binary marker pattern.")
 
+XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARFiducialMarkerDetectorOpencv,
+                             "9a277889-a2d7-4ba5-a542-027bd0eb7b6a",
+                             "SolARFiducialMarkerDetectorOpencv",
+                             "Detects the squared binary markers of an image in a single component.")
+
 XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARFiducialMarkerLoaderOpencv,
                              "d0116ed2-45d7-455d-8011-57959da1b0fa",
                              "SolARFiducialMarkerLoaderOpencv",
@@ -206,6 +215,11 @@ XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARImageFilterBlurOpencv,
                              "SolARImageFilterBlurOpencv",
                              "Blurs an image using the normalized box filter.")
 
+XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARImageFilterChainOpencv,
+                             "9a4d14bf-6267-4142-99c7-e29cb30e67f6",
+                             "SolARImageFilterChainOpencv",
+                             "Blurs, binarizes, erodes and dilates a greyscale image in a single pass over bands of rows.")
+
 XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARImageFilterDilateOpencv,
                              "7ac9d1b8-afda-4c99-b8df-92e71015a3be",
                              "SolARImageFilterDilateOpencv",
@@ -261,6 +275,11 @@ XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolAROpticalFlowPyrLKOpencv
                              "SolAROpticalFlowPyrLKOpencv",
                              "Estimates the optical flow beteen two images based on a pyramidal Lucas Kanade approach.")
 
+XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARDenseOpticalFlowOpencv,
+                             "be3c1268-11f2-41f9-b50b-6c584d943bf4",
+                             "SolARDenseOpticalFlowOpencv",
+                             "Estimates the motion and the blur of each frame of a video stream from a dense optical flow at low resolution.")
+
 XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARPerspectiveControllerOpencv,
                              "9c960f2a-cd6e-11e7-abc4-cec278b6b50a",
                              "SolARPerspectiveControllerOpencv",
@@ -316,6 +335,11 @@ XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARVideoAsCameraOpencv,
                              "SolARVideoAsCameraOpencv",
                              "Grabs the images from a video file.")
 
+XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARVideoRecorderOpencv,
+                             "f91fde00-1864-46c1-b2f6-5b6e32bae80f",
+                             "SolARVideoRecorderOpencv",
+                             "Records timestamped images into a video file or an image sequence in the background.")
+
 XPCF_DEFINE_COMPONENT_TRAITS(SolAR::MODULES::OPENCV::SolARDeviceDataLoader,
 							"4b5576c1-4c44-4835-a405-c8de2d4f85b0",
 							"SolARDeviceDataLoader",
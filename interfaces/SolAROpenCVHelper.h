@@ -54,11 +54,28 @@ public:
     static std::vector<cv::Point2i> convertToOpenCV (const datastructure::Contour2Di &contour);
     static std::vector<cv::Point2f> convertToOpenCV (const datastructure::Contour2Df &contour);
 
+    /// @brief Maps points to a column of CV_32FC2 elements sharing their data, without copy. The Mat can be given to OpenCV as input,
+    /// or as output of the same size to write the points, and is valid while the vector is not reallocated.
+    static cv::Mat mapToOpenCV (const std::vector<datastructure::Point2Df> & points);
+
+    /// @brief Maps points to a column of CV_32FC3 elements sharing their data, without copy, see the 2D version.
+    static cv::Mat mapToOpenCV (const std::vector<datastructure::Point3Df> & points);
+
+    /// @brief Computes the number of 8-connected steps to walk along a closed contour, which is the number of points of a
+    /// contour extracted with cv::CHAIN_APPROX_NONE, whatever the chain approximation used to extract it.
+    /// @param[in] contour: the contour, a vector of cv::Point or cv::Point2f.
+    static double contourChainLength (cv::InputArray contour);
+
     static FrameworkReturnCode convertToSolar( cv::Mat&  imgSrc, SRef<datastructure::Image>& imgDest);
 
     static void mapToOpenCV (SRef<datastructure::Image> imgSrc, cv::Mat& imgDest);
 
     static cv::Mat mapToOpenCV (SRef<datastructure::Image> imgSrc);
+
+    /// @brief Prepares the output image of a filter: an image with the given layout, pixel order and data type is kept and only resized
+    /// if its size differs, so that it is never reallocated while the shape of the input is unchanged, else a new image is allocated.
+    static void prepareImage(uint32_t width, uint32_t height, datastructure::Image::ImageLayout layout, datastructure::Image::PixelOrder pixelOrder,
+                             datastructure::Image::DataType dataType, SRef<datastructure::Image>& image);
     static uint32_t deduceOpenDescriptorCVType(datastructure::DescriptorDataType querytype);
 
     static void drawCVLine (cv::Mat& inputImage, cv::Point2f& p1, cv::Point2f& p2, cv::Scalar color, int thickness);
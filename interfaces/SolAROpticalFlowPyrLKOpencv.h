@@ -39,6 +39,12 @@ namespace OPENCV {
  * @brief <B>Estimates the optical flow between two images based on a pyramidal Lucas Kanade approach.</B>
  * <TT>UUID: b513e9ff-d2e7-4dcf-9a29-4ed95c512158</TT>
  *
+ * The grey conversion and the pyramid with its derivatives of the current image are kept from one call to the next, and reused
+ * when the previous image of the next call has the same content, as in a video stream.
+ * In forward-backward mode, the points are tracked from the previous to the current image and back on the same pyramids,
+ * by chunks processed in parallel. The error of a point is then the distance between its initial position and its position
+ * tracked back, and a point is rejected when this error is greater than maxForwardBackwardError.
+ *
  * @SolARComponentPropertiesBegin
  * @SolARComponentProperty{ searchWinWidth,
  *                          widthHeight in pixels of the search window at each pyramid level,
@@ -65,6 +71,15 @@ namespace OPENCV {
  * @SolARComponentProperty{ searchWindowAccuracy,
  *                          the desired accuracy of the search window before algorithm stops,
  *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 0.03f }}
+ * @SolARComponentProperty{ forwardBackward,
+ *                          if not null\, the points are tracked forward and backward and the error is the forward-backward distance in pixels,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
+ * @SolARComponentProperty{ maxForwardBackwardError,
+ *                          the maximum forward-backward distance in pixels of a tracked point in forward-backward mode,
+ *                          @SolARComponentPropertyDescNum{ float, [0..MAX FLOAT], 1.f }}
+ * @SolARComponentProperty{ profiling,
+ *                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+ *                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
  * @SolARComponentPropertiesEnd
  */
 
@@ -81,7 +96,7 @@ public:
     /// @param[in] pointsToTrack KEYPOINTS The pixels to track in the previous image
     /// @param[out] trackedPoints The position of the pointsToTrack in the current image
     /// @param[out] status Specify for each point; each element of the vector is set to 1 if the flow for the corresponding features has been found, otherwise, it is set to 0.
-    /// @param[out] error Specify for each point the tracking error
+    /// @param[out] error Specify for each point the tracking error, or the forward-backward distance in pixels in forward-backward mode
     /// @return FrameworkReturnCode::_SUCCESS if the estimation is ok, otherwise frameworkReturnCode::_ERROR_
     FrameworkReturnCode estimate(const SRef<datastructure::Image> previousImage,
                                  const SRef<datastructure::Image> currentImage,
@@ -96,7 +111,7 @@ public:
     /// @param[in] pointsToTrack POINT2DF The pixels to track in the previous image
     /// @param[out] trackedPoints The position of the pointsToTrack in the current image
     /// @param[out] status Specify for each point; each element of the vector is set to 1 if the flow for the corresponding features has been found, otherwise, it is set to 0.
-    /// @param[out] error Specify for each point the tracking error
+    /// @param[out] error Specify for each point the tracking error, or the forward-backward distance in pixels in forward-backward mode
     /// @return FrameworkReturnCode::_SUCCESS if the estimation is ok, otherwise frameworkReturnCode::_ERROR_
     FrameworkReturnCode estimate(const SRef<datastructure::Image> previousImage,
                                  const SRef<datastructure::Image> currentImage,
@@ -129,13 +144,46 @@ private:
     // The desired accuracy of the search window before algorithm stops.
     float m_searchWindowAccuracy = 0.03f;
 
+    // If not null, the points are tracked forward and backward.
+    int m_forwardBackward = 0;
+
+    // The maximum forward-backward distance in pixels of a tracked point.
+    float m_maxForwardBackwardError = 1.f;
+    int m_profiling = 0;
+
 
     FrameworkReturnCode estimate(const SRef<datastructure::Image> previousImage,
                                  const SRef<datastructure::Image> currentImage,
-                                 const std::vector<cv::Point2f> & pointsToTrack,
+                                 const cv::Mat & pointsToTrack,
                                  std::vector<datastructure::Point2Df> & trackedPoints,
                                  std::vector<unsigned char> & status,
                                  std::vector<float> & error);
+
+    /// @brief Tracks the points from the previous to the current pyramid and back, by chunks in parallel.
+    /// @param[out] error: the distance between each point and its position tracked back, the maximum float if it is lost in a direction.
+    void trackForwardBackward(const cv::Mat & pointsToTrack,
+                              cv::Mat & trackedPoints,
+                              std::vector<unsigned char> & status,
+                              std::vector<float> & error,
+                              const cv::TermCriteria & termcrit,
+                              int flags);
+
+    /// @brief Converts an image to grey and builds its pyramid with the derivatives of each level.
+    void buildPyramid(const SRef<datastructure::Image> image, const cv::Mat & source, std::vector<cv::Mat> & pyramid);
+
+    /// @brief Returns true if the two images have the same size, type and pixels.
+    static bool sameContent(const cv::Mat & image1, const cv::Mat & image2);
+
+    // the copy of the current image of the last call, and the parameters of its pyramid
+    cv::Mat m_lastSource;
+    cv::Size m_pyramidWinSize;
+    int m_pyramidMaxLevel = -1;
+
+    // buffers kept from one call to the next
+    std::vector<cv::Point2f> m_points;
+    cv::Mat m_grey;
+    std::vector<cv::Mat> m_previousPyramid;
+    std::vector<cv::Mat> m_currentPyramid;
 };
 
 }
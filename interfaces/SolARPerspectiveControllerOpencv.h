@@ -21,6 +21,9 @@
 #include "xpcf/component/ConfigurableBase.h"
 #include "SolAROpencvAPI.h"
 
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+
 namespace SolAR {
 namespace MODULES {
 namespace OPENCV {
@@ -30,6 +33,12 @@ namespace OPENCV {
  * @brief <B>Extracts an unwrapped image from a specific region of an input image defined with four 2D points.</B>
  * <TT>UUID: 9c960f2a-cd6e-11e7-abc4-cec278b6b50a</TT>
  *
+ * The patches of several contours are warped in parallel. The output images already allocated with the size and the layout
+ * of the patches are overwritten instead of being reallocated, and all the patches can be written in a single strip image.
+ * The strip mode is not part of the IPerspectiveController interface: only the code holding the concrete component, for instance
+ * created with xpcf::utils::make_shared<SolARPerspectiveControllerOpencv>(), can call it. The components injected with the
+ * interface, such as the fiducial marker pipelines, only extract the patches.
+ *
  * @SolARComponentPropertiesBegin
  * @SolARComponentProperty{ outputImageWidth,
  *                          the width in pixels of the output image,
@@ -37,6 +46,9 @@ namespace OPENCV {
  * @SolARComponentProperty{ outputImageHeight,
  *                          the Height in pixels of the output image,
  *                          @SolARComponentPropertyDescNum{ int, [0..MAX INT], 480 }}
+ * @SolARComponentProperty{ interpolation,
+ *                          the interpolation of the warp (LINEAR\, NEAREST)\, NEAREST is enough when only binary cells are sampled,
+ *                          @SolARComponentPropertyDescString{ "LINEAR" }}
  * 
  * @SolARComponentPropertiesEnd
  */
@@ -47,9 +59,21 @@ public:
     SolARPerspectiveControllerOpencv();
     ~SolARPerspectiveControllerOpencv() = default;
 
+    org::bcom::xpcf::XPCFErrorCode onConfigured() override final;
+
     FrameworkReturnCode correct(const SRef<datastructure::Image> inputImg, const std::vector<datastructure::Contour2Df> & contours, std::vector<SRef<datastructure::Image>> & patches) override;
     FrameworkReturnCode correct(const SRef<datastructure::Image> inputImg, const datastructure::Contour2Df & contour, SRef<datastructure::Image> & patch) override;
 
+    /// @brief Extracts the patches of all the contours in a single image.
+    /// This overload is not declared by IPerspectiveController, it is only available to the code holding the concrete type.
+    /// @param[in] inputImg: the image from which the patches are extracted.
+    /// @param[in] contours: the contours of the patches, only their four first points are used.
+    /// @param[in,out] strip: an image of outputImageWidth x (outputImageHeight * number of contours) pixels with the layout of the input image,
+    /// the patch of the i-th contour starts at the row i * outputImageHeight, the patch of a contour with less than four points is black.
+    /// The image is reused when it is not null and has the same layout as the input image.
+    /// @return FrameworkReturnCode::_SUCCESS if the patches are extracted, else FrameworkReturnCode::_ERROR_
+    FrameworkReturnCode correct(const SRef<datastructure::Image> inputImg, const std::vector<datastructure::Contour2Df> & contours, SRef<datastructure::Image> & strip);
+
     void unloadComponent () override final;
 
 private:
@@ -57,6 +81,15 @@ private:
     int m_outputImageWidth = 640;
     /// @brief The Height in pixels of the output image
     int m_outputImageHeight = 480;
+    /// @brief The interpolation of the warp (LINEAR, NEAREST)
+    std::string m_interpolation = "LINEAR";
+    /// @brief The OpenCV interpolation flag resolved from m_interpolation
+    int m_interpolationFlag = cv::INTER_LINEAR;
+
+    /// @brief Warps the patch of each contour with at least four points into the corresponding destination, in parallel
+    void warpPatches(const cv::Mat & inputImg, const std::vector<datastructure::Contour2Df> & contours, std::vector<cv::Mat> & destinations);
+
+    std::vector<cv::Mat> m_destinations;
 };
 
 }
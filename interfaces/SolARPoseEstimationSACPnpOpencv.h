@@ -50,6 +50,9 @@ namespace OPENCV {
 * @SolARComponentProperty{ method,
 *                          the method for solving the PnP problem (ITERATIVE\, P3P\, AP3P\, EPNP\, DLS\, UPNP\, IPPE\, IPPE_SQUARE),
 *                          @SolARComponentPropertyDescString{ "ITERATIVE" }}
+* @SolARComponentProperty{ profiling,
+*                          if not null\, the latency of each call is recorded in SolARLatencyProfiler,
+*                          @SolARComponentPropertyDescNum{ int, [0..1], 0 }}
 * @SolARComponentPropertiesEnd
 * 
 */
@@ -100,6 +103,7 @@ private:
 
     /// @brief The method for solving the PnP problem (ITERATIVE, P3P, AP3P, EPNP, DLS, UPNP, IPPE, IPPE_SQUARE)
     std::string m_method = "ITERATIVE";
+    int m_profiling = 0;
 
     cv::Mat m_camMatrix;
     cv::Mat m_camDistorsion;
@@ -96,7 +96,15 @@ public:
 
 
 private:
-
+    /// @brief Estimates the essential matrix between two views with the module's RANSAC estimator.
+    /// @param[in] points_view1, points_view2: matched points in pixels.
+    /// @param[in] threshold: maximum Sampson distance in pixels of an inlier.
+    /// @param[out] inliers: Nx1 CV_8U mask of the inlier matches.
+    /// @return the 3x3 CV_64F essential matrix, empty if the estimation failed.
+    cv::Mat findEssentialMat(const std::vector<cv::Point2f> & points_view1,
+                             const std::vector<cv::Point2f> & points_view2,
+                             float threshold,
+                             cv::Mat & inliers);
 
     ///  @brief threshold to define which point are ouliers
     ///  Here we are using a RANSAC method to remove outlier.
@@ -68,6 +68,7 @@ public:
 private:
     cv::Mat m_camMatrix;
     cv::Mat m_camDistorsion;
+    std::vector<cv::Point3f> m_worldPoints;
 };
 
 }
@@ -27,6 +27,7 @@
 #include <opencv2/imgproc/imgproc.hpp>
 #include "datastructure/DescriptorBuffer.h"
 #include "api/geom/IProject.h"
+#include "SolARUndistortionGrid.h"
 
 #include <vector>
 
@@ -152,6 +153,8 @@ public:
     cv::Mat m_camMatrix;
     // Camera distortion parameters
     cv::Mat m_camDistortion;
+    // Undistortion lookup of the camera
+    SolARUndistortionGrid m_undistortionGrid;
 	// projector
 	SRef<api::geom::IProject> m_projector;
 };
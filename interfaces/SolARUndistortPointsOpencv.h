@@ -21,6 +21,7 @@
 #include "xpcf/component/ComponentBase.h"
 #include "SolAROpencvAPI.h"
 #include "api/geom/IUndistortPoints.h"
+#include "SolARUndistortionGrid.h"
 
 #include "opencv2/core.hpp"
 
@@ -59,6 +60,9 @@ private:
 
     cv::Mat m_camMatrix;
     cv::Mat m_camDistortion;
+
+    SolARUndistortionGrid m_undistortionGrid;
+    std::vector<cv::Point2f> m_points;
 };
 
 }
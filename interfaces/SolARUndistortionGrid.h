@@ -0,0 +1,91 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOLARUNDISTORTIONGRID_H
+#define SOLARUNDISTORTIONGRID_H
+
+#include <vector>
+#include "opencv2/core.hpp"
+
+#include "SolAROpencvAPI.h"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class SolARUndistortionGrid
+ * @brief A lookup table of the undistorted normalized coordinates of a camera, sampled on a sub-pixel grid of the image.
+ *
+ * The grid is built lazily with the iterative solver of OpenCV the first time points are undistorted after the camera parameters
+ * have been set, and then queried by bilinear interpolation. It covers the image when its size is known and grows to the extent
+ * of the queried points, so it is built once per calibration and resolution.
+ * Points far away from the image, or from the optical axis when the image size is unknown, are undistorted with the iterative solver.
+ */
+class SOLAROPENCV_EXPORT_API SolARUndistortionGrid {
+public:
+    /// @brief SolARUndistortionGrid constructor.
+    /// @param[in] step: the distance in pixels between two nodes of the grid.
+    explicit SolARUndistortionGrid(float step = 4.f);
+
+    /// @brief Sets the camera parameters and invalidates the grid.
+    /// @param[in] camMatrix: 3x3 CV_32F intrinsic matrix, the parameters are not set while its focal lengths are null.
+    /// @param[in] camDistortion: 5x1 CV_32F distortion coefficients.
+    /// @param[in] imageSize: the resolution of the camera, empty if unknown.
+    void setCameraParameters(const cv::Mat & camMatrix, const cv::Mat & camDistortion, const cv::Size & imageSize = cv::Size());
+
+    /// @return true if camera parameters have been set.
+    bool isSet() const;
+
+    /// @brief Undistorts points, same output as cv::undistortPoints without rectification nor new projection matrix.
+    /// @param[in] points: the distorted points in pixels.
+    /// @param[out] undistortedPoints: the undistorted points in normalized coordinates, resized to the number of points.
+    /// @return false, with null undistorted points, if the camera parameters have not been set.
+    bool undistort(const std::vector<cv::Point2f> & points, std::vector<cv::Point2f> & undistortedPoints);
+
+    /// @brief Undistorts count points, undistortedPoints can be equal to points.
+    /// @return false, leaving undistortedPoints unchanged, if the camera parameters have not been set.
+    bool undistort(const cv::Point2f * points, size_t count, cv::Point2f * undistortedPoints);
+
+private:
+    bool lookup(float x, float y, cv::Point2f & undistortedPoint) const;
+    void update(const cv::Point2f * points, size_t count);
+    void build(float minX, float minY, float maxX, float maxY);
+
+    float m_step;
+    float m_invStep;
+    cv::Mat m_camMatrix;
+    cv::Mat m_camDistortion;
+    cv::Size m_imageSize;
+
+    // grid nodes, row major, m_mapX[row * m_cols + col] is the undistortion of (m_originX + col * m_step, m_originY + row * m_step)
+    bool m_valid = false;
+    int m_cols = 0;
+    int m_rows = 0;
+    float m_originX = 0.f;
+    float m_originY = 0.f;
+    std::vector<float> m_mapX;
+    std::vector<float> m_mapY;
+
+    std::vector<int> m_outside;
+    std::vector<cv::Point2f> m_outsidePoints;
+};
+
+}
+}
+}
+
+#endif // SOLARUNDISTORTIONGRID_H
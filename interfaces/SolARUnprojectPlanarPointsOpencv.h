@@ -21,6 +21,7 @@
 #include "api/geom/IUnproject.h"
 #include "datastructure/Image.h"
 #include "SolAROpencvAPI.h"
+#include "SolARUndistortionGrid.h"
 #include "xpcf/component/ConfigurableBase.h"
 
 namespace SolAR {
@@ -68,6 +69,8 @@ public:
 private:
     cv::Mat m_camMatrix;
     cv::Mat m_camDistorsion;
+    SolARUndistortionGrid m_undistortionGrid;
+    std::vector<cv::Point2f> m_points;
 };
 
 }
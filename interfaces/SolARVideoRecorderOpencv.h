@@ -0,0 +1,146 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SOLARVIDEORECORDEROPENCV_H
+#define SOLARVIDEORECORDEROPENCV_H
+
+#include "IImageRecorder.h"
+
+#include "xpcf/component/ConfigurableBase.h"
+#include "SolAROpencvAPI.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "opencv2/core.hpp"
+#include "opencv2/videoio.hpp"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+/**
+ * @class SolARVideoRecorderOpencv
+ * @brief <B>Records timestamped images into a video file or an image sequence in the background.</B>
+ * <TT>UUID: f91fde00-1864-46c1-b2f6-5b6e32bae80f</TT>
+ *
+ * The images are copied into a bounded queue and written by a worker thread, with cv::VideoWriter for the VIDEO format,
+ * or one file per image named outputPath_<index>.png for PNG and outputPath_<index>_<width>x<height>x<channels>.raw for RAW.
+ * The index and the timestamp of each image are written in outputPath.timestamps.txt.
+ * When the queue is full, DROP_NEWEST drops the new image, DROP_OLDEST drops the oldest queued image and BLOCK waits
+ * for the worker. The buffers of the written images are reused for the next ones.
+ *
+ * @SolARComponentPropertiesBegin
+ * @SolARComponentProperty{ outputPath,
+ *                          the video file for the VIDEO format\, the prefix of the files for the PNG and RAW formats,
+ *                          @SolARComponentPropertyDescString{ "" }}
+ * @SolARComponentProperty{ format,
+ *                          the output format (VIDEO\, PNG\, RAW),
+ *                          @SolARComponentPropertyDescString{ "VIDEO" }}
+ * @SolARComponentProperty{ codec,
+ *                          the four characters code of the codec of the VIDEO format,
+ *                          @SolARComponentPropertyDescString{ "MJPG" }}
+ * @SolARComponentProperty{ frameRate,
+ *                          the frame rate of the VIDEO format,
+ *                          @SolARComponentPropertyDescNum{ float, ]0..MAX FLOAT], 30.f }}
+ * @SolARComponentProperty{ pngCompression,
+ *                          the compression level of the PNG format\, from 0 (fastest) to 9 (smallest),
+ *                          @SolARComponentPropertyDescNum{ int, [0..9], 1 }}
+ * @SolARComponentProperty{ queueSize,
+ *                          the maximum number of images waiting to be written,
+ *                          @SolARComponentPropertyDescNum{ int, [1..MAX INT], 8 }}
+ * @SolARComponentProperty{ dropPolicy,
+ *                          the policy applied when the queue is full (DROP_NEWEST\, DROP_OLDEST\, BLOCK),
+ *                          @SolARComponentPropertyDescString{ "DROP_NEWEST" }}
+ * @SolARComponentPropertiesEnd
+ */
+
+class SOLAROPENCV_EXPORT_API SolARVideoRecorderOpencv : public org::bcom::xpcf::ConfigurableBase,
+        public IImageRecorder {
+public:
+    SolARVideoRecorderOpencv();
+    ~SolARVideoRecorderOpencv() override;
+
+    /// @brief Copies an image into the queue, the worker thread is started with the first image of a recording.
+    /// @param[in] image: the image to record, with 8 bits per channel for the VIDEO format.
+    /// @param[in] timestamp: the timestamp of the image in milliseconds.
+    /// @return FrameworkReturnCode::_SUCCESS if the image is queued or dropped, else FrameworkReturnCode::_ERROR_
+    FrameworkReturnCode record(const SRef<datastructure::Image> image, double timestamp) override;
+
+    /// @brief Waits for the worker to write the queued images and closes the output.
+    /// @return FrameworkReturnCode::_SUCCESS if all the images have been written, else FrameworkReturnCode::_ERROR_
+    FrameworkReturnCode close() override;
+
+    uint32_t getQueueDepth() const override;
+
+    uint32_t getNbDroppedImages() const override;
+
+    uint32_t getNbRecordedImages() const override;
+
+    void unloadComponent () override final;
+
+private:
+    struct QueuedImage {
+        cv::Mat image;
+        double timestamp;
+        uint32_t index;
+    };
+
+    void writeLoop();
+    bool write(const QueuedImage & queued);
+
+    std::string m_outputPath = "";
+    std::string m_format = "VIDEO";
+    std::string m_codec = "MJPG";
+    float m_frameRate = 30.f;
+    int m_pngCompression = 1;
+    int m_queueSize = 8;
+    std::string m_dropPolicy = "DROP_NEWEST";
+
+    // format and drop policy of the current recording
+    int m_formatId = 0;
+    int m_dropPolicyId = 0;
+
+    std::thread m_worker;
+    mutable std::mutex m_queueMutex;
+    std::condition_variable m_queueNotEmpty;
+    std::condition_variable m_queueNotFull;
+    std::deque<QueuedImage> m_queue;
+    std::vector<cv::Mat> m_freeImages;
+    bool m_stop = false;
+    uint32_t m_nbImages = 0;
+
+    std::atomic<uint32_t> m_nbDropped{0};
+    std::atomic<uint32_t> m_nbRecorded{0};
+    std::atomic<bool> m_failed{false};
+
+    // outputs, only used by the worker
+    cv::VideoWriter m_writer;
+    cv::Size m_videoSize;
+    std::ofstream m_timestamps;
+};
+
+}
+}
+}  // end of namespace Solar
+
+#endif // SOLARVIDEORECORDEROPENCV_H
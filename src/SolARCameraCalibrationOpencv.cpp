@@ -22,6 +22,12 @@
 #include "opencv2/calib3d.hpp"
 #include "opencv2/highgui.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <limits>
+
 namespace xpcf  = org::bcom::xpcf;
 
 XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARCameraCalibrationOpencv)
@@ -31,7 +37,38 @@ namespace SolAR {
 namespace MODULES {
 namespace OPENCV {
 
+namespace {
+
+// at most this number of frames are decoded and searched at once
+const int MAX_BATCH_SIZE = 8;
 
+// the camera is calibrated while capturing from this number of selected views
+const size_t MIN_INCREMENTAL_VIEWS = 3;
+
+struct IncrementalCalibration
+{
+    double rms = -1.;
+    cv::Mat cameraMatrix;
+    cv::Mat distCoeffs;
+};
+
+// Decodes up to views.size() frames with their timestamps in milliseconds, returns the number of decoded frames
+int readFrames(cv::VideoCapture & capture, bool live, cv::Mat & frame, std::vector<cv::Mat> & views, std::vector<double> & timestamps)
+{
+    int nbViews = 0;
+    for (; nbViews < static_cast<int>(views.size()); nbViews++)
+    {
+        capture >> frame;
+        if (frame.empty())
+            break;
+        // the capture may return its own buffer, each frame of the batch is copied
+        frame.copyTo(views[nbViews]);
+        timestamps[nbViews] = live ? cv::getTickCount() * 1e3 / cv::getTickFrequency() : capture.get(cv::CAP_PROP_POS_MSEC);
+    }
+    return nbViews;
+}
+
+}
 
 SolARCameraCalibrationOpencv::SolARCameraCalibrationOpencv():ComponentBase(xpcf::toUUID<SolARCameraCalibrationOpencv>())
 {
@@ -216,84 +253,224 @@ bool SolARCameraCalibrationOpencv::calibrate(int camera_id, const std::string &
 }
 
 
-bool SolARCameraCalibrationOpencv::process(cv::VideoCapture & capture, const std::string & output)
+bool SolARCameraCalibrationOpencv::detectCorners(const cv::Mat & view, std::vector<cv::Point2f> & corners) const
 {
-	cv::Size imageSize;
-	int i;
-	clock_t prevTimestamp = 0;
-	ProcessMode mode = SOLAR_DETECT;
-	std::vector<std::vector<cv::Point2f> > imagePoints;
+    cv::Mat viewGray, smallGray;
+    cv::cvtColor(view, viewGray, cv::COLOR_BGR2GRAY);
+
+    // most of the frames do not show the whole chessboard, they are rejected at low resolution by the fast check
+    double scale = (m_detectionWidth > 0 && viewGray.cols > m_detectionWidth) ? static_cast<double>(m_detectionWidth) / viewGray.cols : 1.;
+    if (scale < 1.)
+        cv::resize(viewGray, smallGray, cv::Size(), scale, scale, cv::INTER_AREA);
+    else
+        smallGray = viewGray;
+    if (!cv::findChessboardCorners(smallGray, m_boardSize, corners, cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_FAST_CHECK))
+    {
+        // a small or distant chessboard may be lost by the downscale, it is searched again at full resolution
+        if (scale == 1.)
+            return false;
+        scale = 1.;
+        if (!cv::findChessboardCorners(viewGray, m_boardSize, corners, cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_FAST_CHECK))
+            return false;
+    }
 
-    for (i = 0;; i++){
-        cv::Mat view, viewGray;
-        bool blink = false;
+    // improve the found corners' coordinate accuracy at full resolution
+    if (scale < 1.)
+    {
+        float invScale = static_cast<float>(1. / scale);
+        for (auto & corner : corners)
+            corner = cv::Point2f((corner.x + 0.5f) * invScale - 0.5f, (corner.y + 0.5f) * invScale - 0.5f);
+    }
+    cv::cornerSubPix(viewGray, corners, cv::Size(11, 11),
+        cv::Size(-1, -1), cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1));
+    return true;
+}
 
-        if (capture.isOpened())
+bool SolARCameraCalibrationOpencv::isNewView(const std::vector<std::vector<cv::Point2f>> & imagePoints, const std::vector<cv::Point2f> & corners, cv::Size imageSize) const
+{
+    double minDistance = m_minViewDistance * std::sqrt(static_cast<double>(imageSize.width) * imageSize.width + static_cast<double>(imageSize.height) * imageSize.height);
+    size_t nbCorners = corners.size();
+    for (const auto & selectedCorners : imagePoints)
+    {
+        // the corners of a chessboard may be found in the reverse order, so both orders are compared
+        double distance = 0., reverseDistance = 0.;
+        for (size_t i = 0; i < nbCorners; i++)
         {
-            cv::Mat view0;
-            capture >> view0;
-            view0.copyTo(view);
+            distance += cv::norm(corners[i] - selectedCorners[i]);
+            reverseDistance += cv::norm(corners[i] - selectedCorners[nbCorners - 1 - i]);
         }
-        imageSize = view.size();
-
-        std::vector<cv::Point2f> pointbuf;
-        cv::cvtColor(view, viewGray, cv::COLOR_BGR2GRAY);
-        bool found;
-            found = cv::findChessboardCorners(view, m_boardSize, pointbuf,
-                cv::CALIB_CB_ADAPTIVE_THRESH);
-
-        // improve the found corners' coordinate accuracy
-        if (found) cornerSubPix(viewGray, pointbuf, cv::Size(11, 11),
-            cv::Size(-1, -1), cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.1));
-
-        if (mode == SOLAR_CAPTURE && found &&
-            (!capture.isOpened() || clock() - prevTimestamp > m_delay*1e-3*CLOCKS_PER_SEC)){
-            imagePoints.push_back(pointbuf);
-            prevTimestamp = clock();
-            blink = capture.isOpened();
-        }
-
-        if (found)
-            cv::drawChessboardCorners(view, m_boardSize, cv::Mat(pointbuf), found);
-
-        std::string msg = mode == SOLAR_CAPTURE ? "100/100" :
-            mode == SOLAR_CALIBRATED ? "Calibrated" : "Press 'g' to start";
-        int baseLine = 0;
-
-        cv::Size textSize = cv::getTextSize(msg, 1, 1, 1, &baseLine);
-        cv::Point textOrigin(view.cols - 2 * textSize.width - 10, view.rows - 2 * baseLine - 10);
-
-        if (mode == SOLAR_CAPTURE)
-                msg = cv::format("%d/%d", (int)imagePoints.size(), m_nframes);
-
-        cv::putText(view, msg, textOrigin, 1, 1,
-            mode != SOLAR_CALIBRATED ? cv::Scalar(0, 0, 255) : cv::Scalar(0, 255, 0));
-
-        if (blink)
-            cv::bitwise_not(view, view);
+        if (std::min(distance, reverseDistance) < minDistance * nbCorners)
+            return false;
+    }
+    return true;
+}
 
-        cv::imshow("Image View", view);
-        char key = (char)cv::waitKey(capture.isOpened() ? 50 : 500);
+double SolARCameraCalibrationOpencv::getCurrentRMS() const
+{
+    return m_currentRMS;
+}
 
-        if (key == 27)
-            break;
+bool SolARCameraCalibrationOpencv::process(cv::VideoCapture & capture, const std::string & output)
+{
+	cv::Size imageSize;
+	double prevTimestamp = -std::numeric_limits<double>::infinity();
+	// a video file is captured from its first frame and timed by its own timestamps
+	bool live = capture.get(cv::CAP_PROP_FRAME_COUNT) <= 0;
+	ProcessMode mode = live ? SOLAR_DETECT : SOLAR_CAPTURE;
+	std::vector<std::vector<cv::Point2f> > imagePoints;
+	m_currentRMS = -1.;
+
+	// the chessboard is searched in parallel in a batch of frames while the next batch is decoded,
+	// a live camera is processed frame by frame to keep the display and the keys responsive
+	int batchSize = live ? 1 : std::min(std::max(cv::getNumThreads(), 1), MAX_BATCH_SIZE);
+	cv::Mat frame;
+	std::vector<cv::Mat> views(batchSize), nextViews(batchSize);
+	std::vector<double> timestamps(batchSize), nextTimestamps(batchSize);
+	std::vector<std::vector<cv::Point2f>> corners(batchSize);
+	std::vector<char> found(batchSize);
+	int nbViews = readFrames(capture, live, frame, views, timestamps);
+
+	// the camera is calibrated in the background every time a view is selected, from the previous estimate
+	std::future<IncrementalCalibration> incremental;
+	IncrementalCalibration estimate;
+
+	bool stop = false;
+	while (nbViews > 0 && !stop)
+	{
+		std::future<void> detection = std::async(std::launch::async, [&, nbViews]() {
+			cv::parallel_for_(cv::Range(0, nbViews), [&](const cv::Range & range) {
+				for (int k = range.start; k < range.end; k++)
+					found[k] = detectCorners(views[k], corners[k]);
+			});
+		});
+		int nbNextViews = readFrames(capture, live, frame, nextViews, nextTimestamps);
+		detection.get();
+
+		for (int k = 0; k < nbViews; k++)
+		{
+			cv::Mat & view = views[k];
+			bool blink = false;
+			imageSize = view.size();
+
+			if (mode == SOLAR_CAPTURE && found[k] && timestamps[k] - prevTimestamp > m_delay
+				&& isNewView(imagePoints, corners[k], imageSize))
+			{
+				imagePoints.push_back(corners[k]);
+				prevTimestamp = timestamps[k];
+				blink = live;
+
+				if (imagePoints.size() >= MIN_INCREMENTAL_VIEWS
+					&& (!incremental.valid() || incremental.wait_for(std::chrono::seconds(0)) == std::future_status::ready))
+				{
+					if (incremental.valid())
+						estimate = incremental.get();
+					incremental = std::async(std::launch::async, [this, imagePoints, imageSize, estimate]() {
+						IncrementalCalibration result;
+						std::vector<std::vector<cv::Point3f> > objectPoints(1);
+						calcChessboardCorners(m_boardSize, m_squareSize, objectPoints[0]);
+						objectPoints.resize(imagePoints.size(), objectPoints[0]);
+						int flags = m_flags | cv::CALIB_FIX_K4 | cv::CALIB_FIX_K5;
+						if (estimate.rms >= 0.)
+						{
+							result.cameraMatrix = estimate.cameraMatrix.clone();
+							result.distCoeffs = estimate.distCoeffs.clone();
+							flags |= cv::CALIB_USE_INTRINSIC_GUESS;
+						}
+						else
+						{
+							// there is no estimate to start from yet, the first solve initializes the intrinsics itself
+							flags &= ~cv::CALIB_USE_INTRINSIC_GUESS;
+							result.cameraMatrix = cv::Mat::eye(3, 3, CV_64F);
+							if (m_flags & cv::CALIB_FIX_ASPECT_RATIO)
+								result.cameraMatrix.at<double>(0, 0) = m_aspectRatio;
+							result.distCoeffs = cv::Mat::zeros(8, 1, CV_64F);
+						}
+						try
+						{
+							double rms = cv::calibrateCamera(objectPoints, imagePoints, imageSize, result.cameraMatrix,
+								result.distCoeffs, cv::noArray(), cv::noArray(), flags);
+							if (cv::checkRange(result.cameraMatrix) && cv::checkRange(result.distCoeffs))
+							{
+								result.rms = rms;
+								m_currentRMS = rms;
+								LOG_INFO("RMS error with {} views: {:g}", imagePoints.size(), rms)
+							}
+						}
+						catch (const cv::Exception & e)
+						{
+							LOG_WARNING("Calibration with {} views failed: {}", imagePoints.size(), e.what())
+						}
+						return result;
+					});
+				}
+			}
+
+			if (found[k])
+				cv::drawChessboardCorners(view, m_boardSize, cv::Mat(corners[k]), true);
+
+			std::string msg = mode == SOLAR_CAPTURE ? "100/100 RMS 0.00" :
+				mode == SOLAR_CALIBRATED ? "Calibrated" : "Press 'g' to start";
+			int baseLine = 0;
+
+			cv::Size textSize = cv::getTextSize(msg, 1, 1, 1, &baseLine);
+			cv::Point textOrigin(view.cols - 2 * textSize.width - 10, view.rows - 2 * baseLine - 10);
+
+			if (mode == SOLAR_CAPTURE)
+			{
+				double rms = m_currentRMS;
+				msg = rms < 0. ? cv::format("%d/%d", (int)imagePoints.size(), m_nframes) :
+					cv::format("%d/%d RMS %.2f", (int)imagePoints.size(), m_nframes, rms);
+			}
+
+			cv::putText(view, msg, textOrigin, 1, 1,
+				mode != SOLAR_CALIBRATED ? cv::Scalar(0, 0, 255) : cv::Scalar(0, 255, 0));
+
+			if (blink)
+				cv::bitwise_not(view, view);
+
+			cv::imshow("Image View", view);
+			char key = (char)cv::waitKey(live ? 50 : 1);
+
+			if (key == 27)
+			{
+				stop = true;
+				break;
+			}
+
+			if (live && key == 'g')
+			{
+				mode = SOLAR_CAPTURE;
+				imagePoints.clear();
+				if (incremental.valid())
+					incremental.wait();
+				incremental = std::future<IncrementalCalibration>();
+				estimate = IncrementalCalibration();
+				m_currentRMS = -1.;
+			}
+			if (mode == SOLAR_CAPTURE && imagePoints.size() >= (unsigned)m_nframes)
+			{
+				if (runAndSave(output, imagePoints, imageSize,
+					m_boardSize, m_squareSize, m_aspectRatio,
+					m_flags, m_camMatrix, m_camDistorsion))
+					mode = SOLAR_CALIBRATED;
+				else
+					mode = SOLAR_DETECT;
+				if (!live)
+				{
+					stop = true;
+					break;
+				}
+			}
+		}
+
+		std::swap(views, nextViews);
+		std::swap(timestamps, nextTimestamps);
+		nbViews = nbNextViews;
+	}
 
-        if (capture.isOpened() && key == 'g'){
-            mode = SOLAR_CAPTURE;
-            imagePoints.clear();
-        }
-        if (mode == SOLAR_CAPTURE && imagePoints.size() >= (unsigned)m_nframes){
-            if (runAndSave(output, imagePoints, imageSize,
-                m_boardSize, m_squareSize, m_aspectRatio,
-                m_flags, m_camMatrix, m_camDistorsion))
-                mode = SOLAR_CALIBRATED;
-            else
-                mode = SOLAR_DETECT;
-            if (!capture.isOpened())
-                break;
-        }
-    }
-    return true;
+	if (mode == SOLAR_CAPTURE && !stop)
+		LOG_WARNING("End of the stream reached with {} views selected out of {}", imagePoints.size(), m_nframes)
+	return true;
 }
 
 //
@@ -394,7 +571,10 @@ bool SolARCameraCalibrationOpencv::setParameters(const std::string & config_file
         m_nframes = (int)fs["nb_frames"];
         m_flags = (int)fs["flags"];
         m_delay = (int)fs["delay"];
-
+        if (!fs["detection_width"].empty())
+            m_detectionWidth = (int)fs["detection_width"];
+        if (!fs["min_view_distance"].empty())
+            m_minViewDistance = (float)fs["min_view_distance"];
 
         fs.release();
 
@@ -405,6 +585,8 @@ bool SolARCameraCalibrationOpencv::setParameters(const std::string & config_file
         LOG_DEBUG("    ->nb frames: {}", m_nframes)
         LOG_DEBUG("    ->flags: {}", m_flags)
         LOG_DEBUG("    ->delay: {}", m_delay)
+        LOG_DEBUG("    ->detection width: {}", m_detectionWidth)
+        LOG_DEBUG("    ->min view distance: {}", m_minViewDistance)
 
     }
     else
@@ -33,6 +33,7 @@ namespace OPENCV {
     {
         declareInterface<api::features::IContoursExtractor>(this);
         declareProperty("minContourEdges",m_minContourEdges);
+        declareProperty("chainApproximation",m_chainApproximation);
     }
 
     FrameworkReturnCode SolARContoursExtractorOpencv::extract(const SRef<Image> inputImg, std::vector<Contour2Df> & contours)
@@ -47,22 +48,25 @@ namespace OPENCV {
         SolAROpenCVHelper::mapToOpenCV(inputImg, thresholdImg);
         if(!thresholdImg.empty())
         {
-            std::vector<std::vector<cv::Point>> ocv_contours;
-            cv::findContours(thresholdImg, ocv_contours, cv::RETR_LIST, cv::CHAIN_APPROX_NONE);
-            contours.clear();
-            for (size_t i = 0; i<ocv_contours.size(); i++)
+            bool simpleChains = m_chainApproximation == 1;
+            cv::findContours(thresholdImg, m_ocvContours, cv::RETR_LIST, simpleChains ? cv::CHAIN_APPROX_SIMPLE : cv::CHAIN_APPROX_NONE);
+
+            // The output contours are reused from one call to the next, only their points are overwritten
+            size_t nbContours = 0;
+            for (const auto & ocvContour : m_ocvContours)
             {
-                size_t contourSize = ocv_contours[i].size();
-                if (contourSize > m_minContourEdges)
-                {
-                    Contour2Df contour;
-                    for (size_t j = 0; j < contourSize; j++)
-                    {
-                        contour.push_back(Point2Df(ocv_contours[i][j].x, ocv_contours[i][j].y));
-                    }
-                    contours.push_back(contour);
-                }
+                // Drop the too short contours before any conversion, a compressed chain is measured by its uncompressed length
+                double contourLength = simpleChains ? SolAROpenCVHelper::contourChainLength(ocvContour) : static_cast<double>(ocvContour.size());
+                if (contourLength <= m_minContourEdges)
+                    continue;
+                if (nbContours == contours.size())
+                    contours.emplace_back();
+                Contour2Df & contour = contours[nbContours++];
+                contour.resize(ocvContour.size());
+                for (size_t j = 0; j < ocvContour.size(); j++)
+                    contour[j] = Point2Df(ocvContour[j].x, ocvContour[j].y);
             }
+            contours.resize(nbContours);
         }
         else
         {
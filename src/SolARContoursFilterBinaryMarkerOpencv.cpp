@@ -19,6 +19,10 @@
 
 #include "opencv2/opencv.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
 namespace xpcf = org::bcom::xpcf;
 
 XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARContoursFilterBinaryMarkerOpencv)
@@ -48,93 +52,129 @@ namespace OPENCV {
         return sum;
     }
 
+    // Key of a cell of the grid of centroids, sorted by row then by column
+    inline int64_t cellKey(int x, int y)
+    {
+        return (static_cast<int64_t>(y) << 32) | static_cast<uint32_t>(x);
+    }
+
     FrameworkReturnCode SolARContoursFilterBinaryMarkerOpencv::filter(const std::vector<Contour2Df> & input_contours, std::vector<Contour2Df> & filtered_contours)
     {
-        std::vector<cv::Point2i> approxCurve;
         std::vector<Contour2Df> possibleMarkers;
+        Contour2Df quad;
         // For each contour, analyze if it is a parallelepiped likely to be the marker
         for (size_t i = 0; i<input_contours.size(); i++)
         {
-            // Approximate to a polygon
-            double eps = input_contours[i].size() * m_epsilon;
-            cv::approxPolyDP(SolAROpenCVHelper::convertToOpenCV(input_contours[i]), approxCurve, eps, true);
-            // We interested only in polygons that contains only four points and that are convex
-            if ((approxCurve.size() == 4) && (cv::isContourConvex(approxCurve)))
-            {
-                // Ensure that the distance between consecutive points is large enough
-                float minDist = std::numeric_limits<float>::max();
-                for (int i = 0; i < 4; i++){
-                    cv::Point side = approxCurve[i] - approxCurve[(i + 1) % 4];
-                    float squaredSideLength = side.dot(side);
-                    minDist = std::min(minDist, squaredSideLength);
-                }
-                // Check that distance is not very small
-                if (minDist > m_minContourLength)
-                {
-                    Contour2Df contour;
-                    for (int i = 0; i<4; i++)
-                    {
-                        contour.push_back(Point2Df(approxCurve[i].x, approxCurve[i].y));
-                     }
-                    Point2Df v1 = (contour[1]) - (contour[0]);
-                    Point2Df v2 = (contour[2]) - (contour[0]);
-
-                    double o = (v1[0] * v2[1]) - (v1[1] * v2[0]);
-                    if (o < 0.0){		 //if the third point is in the left side, then sort in anti-clockwise order
-                        Point2Df temp_point = contour[3];
-                        contour[3] = contour[1];
-                        contour[1] = temp_point;
-                    }
-                    possibleMarkers.push_back(contour);
-                }
-            }
+            m_points.resize(input_contours[i].size());
+            for (size_t j = 0; j < input_contours[i].size(); j++)
+                m_points[j] = cv::Point2f(input_contours[i][j].getX(), input_contours[i][j].getY());
+            if (approximateQuad(m_points, m_epsilon, m_minContourLength, quad))
+                possibleMarkers.push_back(quad);
         }
 
+        removeTooNearCandidates(possibleMarkers, m_minDistanceBetweenContourCorners, filtered_contours);
+        return FrameworkReturnCode::_SUCCESS;
+    }
+
+    bool SolARContoursFilterBinaryMarkerOpencv::approximateQuad(cv::InputArray contour, float epsilon, float minContourLength, Contour2Df & quad)
+    {
+        std::vector<cv::Point2i> approxCurve;
+        // Approximate to a polygon, the accuracy does not depend on the chain approximation of the contour
+        double eps = SolAROpenCVHelper::contourChainLength(contour) * epsilon;
+        cv::approxPolyDP(contour, approxCurve, eps, true);
+        // We interested only in polygons that contains only four points and that are convex
+        if ((approxCurve.size() != 4) || (!cv::isContourConvex(approxCurve)))
+            return false;
+
+        // Ensure that the distance between consecutive points is large enough
+        float minDist = std::numeric_limits<float>::max();
+        for (int i = 0; i < 4; i++){
+            cv::Point side = approxCurve[i] - approxCurve[(i + 1) % 4];
+            float squaredSideLength = side.dot(side);
+            minDist = std::min(minDist, squaredSideLength);
+        }
+        // Check that distance is not very small
+        if (minDist <= minContourLength)
+            return false;
+
+        quad.clear();
+        for (int i = 0; i<4; i++)
+        {
+            quad.push_back(Point2Df(approxCurve[i].x, approxCurve[i].y));
+        }
+        Point2Df v1 = (quad[1]) - (quad[0]);
+        Point2Df v2 = (quad[2]) - (quad[0]);
+
+        double o = (v1[0] * v2[1]) - (v1[1] * v2[0]);
+        if (o < 0.0){		 //if the third point is in the left side, then sort in anti-clockwise order
+            Point2Df temp_point = quad[3];
+            quad[3] = quad[1];
+            quad[1] = temp_point;
+        }
+        return true;
+    }
+
+    void SolARContoursFilterBinaryMarkerOpencv::removeTooNearCandidates(const std::vector<Contour2Df> & possibleMarkers, float minDistanceBetweenContourCorners, std::vector<Contour2Df> & filtered_contours)
+    {
         // Remove candidates for which a corner is close to the same corner of another contour
-        std::vector<std::pair<int, int>> tooNearCandidates;
-        float minSquaredDistance = m_minDistanceBetweenContourCorners * m_minDistanceBetweenContourCorners;
-        for (size_t i = 0; i<possibleMarkers.size(); i++)
+        size_t nbCandidates = possibleMarkers.size();
+        std::vector<bool> removalMask(nbCandidates, false);
+        // only the squared distance is compared, as before the grid was introduced, so a negative distance behaves as its absolute value
+        float minSquaredDistance = minDistanceBetweenContourCorners * minDistanceBetweenContourCorners;
+        if (minSquaredDistance > 0.f && nbCandidates > 1)
         {
-            //calculate the average distance of each corner to the nearest corner of the other marker candidate
-            for (size_t j = i + 1; j<possibleMarkers.size(); j++)
+            // The centroids of two candidates whose corners are on average closer than the minimum distance are closer than this distance,
+            // so only the candidates of neighboring cells of a grid of centroids with twice this size are compared
+            float invCellSize = 0.5f / std::abs(minDistanceBetweenContourCorners);
+            std::vector<float> perimeters(nbCandidates);
+            std::vector<cv::Point> candidateCells(nbCandidates);
+            std::vector<std::pair<int64_t, int>> cells(nbCandidates);
+            for (size_t i = 0; i < nbCandidates; i++)
             {
-                float distSquared = 0;
-                for (int c = 0; c < 4; c++)
-                {
-                    Point2Df v = (possibleMarkers[i])[c] - (possibleMarkers[j][c]);
-                    distSquared += v.dot(v);
-                }
-                distSquared /= 4;
-                if (distSquared < minSquaredDistance)
-                {
-                    tooNearCandidates.push_back(std::pair<int, int>(static_cast<int>(i), static_cast<int>(j)));
-                }
+                const Contour2Df & candidate = possibleMarkers[i];
+                perimeters[i] = computePerimeter(candidate);
+                float cx = (candidate[0].getX() + candidate[1].getX() + candidate[2].getX() + candidate[3].getX()) * 0.25f;
+                float cy = (candidate[0].getY() + candidate[1].getY() + candidate[2].getY() + candidate[3].getY()) * 0.25f;
+                candidateCells[i] = cv::Point(cvFloor(cx * invCellSize), cvFloor(cy * invCellSize));
+                cells[i] = std::make_pair(cellKey(candidateCells[i].x, candidateCells[i].y), static_cast<int>(i));
             }
-        }
+            std::sort(cells.begin(), cells.end());
 
-        // If two contours have the same corners that are too close, keep the contour with the bigger perimeter
-        std::vector<bool> removalMask(possibleMarkers.size(), false);
-        for (size_t i = 0; i<tooNearCandidates.size(); i++)
-        {
-            float p1 = computePerimeter(possibleMarkers[tooNearCandidates[i].first]);
-            float p2 = computePerimeter(possibleMarkers[tooNearCandidates[i].second]);
-            size_t removalIndex;
-            if (p1 > p2)
-                removalIndex = tooNearCandidates[i].second;
-            else
-                removalIndex = tooNearCandidates[i].first;
-
-            removalMask[removalIndex] = true;
+            // Each pair is compared once, from its lower index
+            for (size_t i = 0; i < nbCandidates; i++)
+            {
+                const Contour2Df & candidate = possibleMarkers[i];
+                for (int dy = -1; dy <= 1; dy++)
+                    for (int dx = -1; dx <= 1; dx++)
+                    {
+                        int64_t key = cellKey(candidateCells[i].x + dx, candidateCells[i].y + dy);
+                        auto it = std::lower_bound(cells.begin(), cells.end(), std::make_pair(key, static_cast<int>(i) + 1));
+                        for (; it != cells.end() && it->first == key; ++it)
+                        {
+                            // calculate the average distance of each corner to the same corner of the other marker candidate
+                            size_t j = static_cast<size_t>(it->second);
+                            float distSquared = 0;
+                            for (int c = 0; c < 4; c++)
+                            {
+                                Point2Df v = candidate[c] - possibleMarkers[j][c];
+                                distSquared += v.dot(v);
+                            }
+                            distSquared /= 4;
+                            // If two contours have the same corners that are too close, keep the contour with the bigger perimeter
+                            if (distSquared < minSquaredDistance)
+                                removalMask[perimeters[i] > perimeters[j] ? j : i] = true;
+                        }
+                    }
+            }
         }
 
         // Return candidates
         filtered_contours.clear();
-        for (size_t i = 0; i<possibleMarkers.size(); i++)
+        for (size_t i = 0; i < nbCandidates; i++)
         {
             if (!removalMask[i])
                 filtered_contours.push_back(possibleMarkers[i]);
         }
-        return FrameworkReturnCode::_SUCCESS;
     }
 
 }
@@ -0,0 +1,145 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "SolARDenseOpticalFlowOpencv.h"
+#include "SolAROpenCVHelper.h"
+#include "core/Log.h"
+
+#include "opencv2/imgproc.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace xpcf = org::bcom::xpcf;
+XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARDenseOpticalFlowOpencv)
+
+namespace SolAR {
+using namespace datastructure;
+namespace MODULES {
+namespace OPENCV {
+
+static std::map<std::string, int> convertPreset = {{"ULTRAFAST", cv::DISOpticalFlow::PRESET_ULTRAFAST},
+                                                   {"FAST", cv::DISOpticalFlow::PRESET_FAST},
+                                                   {"MEDIUM", cv::DISOpticalFlow::PRESET_MEDIUM}};
+
+// the flow is sampled on one pixel out of FLOW_SAMPLING_STEP in each direction to compute its median
+static const int FLOW_SAMPLING_STEP = 2;
+
+SolARDenseOpticalFlowOpencv::SolARDenseOpticalFlowOpencv():ConfigurableBase(xpcf::toUUID<SolARDenseOpticalFlowOpencv>())
+{
+    declareInterface<IFrameMotionEstimator>(this);
+    declareProperty("width", m_width);
+    declareProperty("preset", m_preset);
+    declareProperty("sharpnessDecay", m_sharpnessDecay);
+    LOG_DEBUG("SolARDenseOpticalFlowOpencv constructor");
+}
+
+xpcf::XPCFErrorCode SolARDenseOpticalFlowOpencv::onConfigured()
+{
+    auto itr = convertPreset.find(m_preset);
+    if (itr == convertPreset.end())
+    {
+        LOG_WARNING("Dense optical flow preset {} does not exist, ULTRAFAST is used", m_preset);
+        m_flow = cv::DISOpticalFlow::create(cv::DISOpticalFlow::PRESET_ULTRAFAST);
+    }
+    else
+        m_flow = cv::DISOpticalFlow::create(itr->second);
+    return xpcf::XPCFErrorCode::_SUCCESS;
+}
+
+FrameworkReturnCode SolARDenseOpticalFlowOpencv::estimate(const SRef<Image> image, float & medianFlow, float & blurScore)
+{
+    medianFlow = 0.f;
+    blurScore = 0.f;
+    if (image == nullptr)
+    {
+        LOG_ERROR("The input image of SolARDenseOpticalFlowOpencv is null");
+        return FrameworkReturnCode::_ERROR_;
+    }
+    if (image->getDataType() != Image::DataType::TYPE_8U)
+    {
+        LOG_ERROR("SolARDenseOpticalFlowOpencv takes only images with 8 bits per channel as input");
+        return FrameworkReturnCode::_ERROR_;
+    }
+    if (!m_flow)
+        onConfigured();
+
+    // Grey conversion, the input image is used as is when it is already grey
+    cv::Mat cvImage = SolAROpenCVHelper::mapToOpenCV(image);
+    cv::Mat grey;
+    switch (image->getImageLayout()) {
+    case Image::ImageLayout::LAYOUT_GREY:
+        grey = cvImage;
+        break;
+    case Image::ImageLayout::LAYOUT_RGB:
+        cv::cvtColor(cvImage, m_grey, cv::COLOR_RGB2GRAY);
+        grey = m_grey;
+        break;
+    case Image::ImageLayout::LAYOUT_BGR:
+        cv::cvtColor(cvImage, m_grey, cv::COLOR_BGR2GRAY);
+        grey = m_grey;
+        break;
+    default:
+        LOG_ERROR("SolARDenseOpticalFlowOpencv takes only grey, RGB or BGR images as input");
+        return FrameworkReturnCode::_ERROR_;
+    }
+
+    // Downscale, the frame is copied as it is kept for the next one
+    float scale = 1.f;
+    if (grey.cols > m_width && m_width > 0)
+    {
+        scale = static_cast<float>(m_width) / grey.cols;
+        cv::resize(grey, m_current, cv::Size(m_width, std::max(cvRound(grey.rows * scale), 1)), 0, 0, cv::INTER_AREA);
+    }
+    else
+        grey.copyTo(m_current);
+
+    // Blur, the sharpness is the variance of the Laplacian
+    cv::Laplacian(m_current, m_laplacian, CV_16S);
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(m_laplacian, mean, stddev);
+    float sharpness = static_cast<float>(stddev[0] * stddev[0]);
+    m_maxSharpness = std::max(sharpness, m_maxSharpness * m_sharpnessDecay);
+    blurScore = m_maxSharpness > 0.f ? 1.f - sharpness / m_maxSharpness : 1.f;
+
+    // Motion, the median of the squared magnitudes is the square of the median magnitude
+    if (m_previous.size() == m_current.size())
+    {
+        m_flow->calc(m_previous, m_current, m_flowField);
+        m_squaredMagnitudes.clear();
+        for (int row = FLOW_SAMPLING_STEP / 2; row < m_flowField.rows; row += FLOW_SAMPLING_STEP)
+        {
+            const cv::Point2f * flow = m_flowField.ptr<cv::Point2f>(row);
+            for (int col = FLOW_SAMPLING_STEP / 2; col < m_flowField.cols; col += FLOW_SAMPLING_STEP)
+                m_squaredMagnitudes.push_back(flow[col].dot(flow[col]));
+        }
+        if (!m_squaredMagnitudes.empty())
+        {
+            auto median = m_squaredMagnitudes.begin() + m_squaredMagnitudes.size() / 2;
+            std::nth_element(m_squaredMagnitudes.begin(), median, m_squaredMagnitudes.end());
+            medianFlow = std::sqrt(*median) / scale;
+        }
+    }
+    std::swap(m_previous, m_current);
+
+    return FrameworkReturnCode::_SUCCESS;
+}
+
+}
+}
+}  // end of namespace Solar
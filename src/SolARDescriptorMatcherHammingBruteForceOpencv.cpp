@@ -15,6 +15,7 @@
  */
 
 #include "SolARDescriptorMatcherHammingBruteForceOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
@@ -33,6 +34,7 @@ SolARDescriptorMatcherHammingBruteForceOpencv::SolARDescriptorMatcherHammingBrut
 
     declareInterface<IDescriptorMatcher>(this);
     declareProperty("distanceRatio", m_distanceRatio);
+    declareProperty("profiling", m_profiling);
     LOG_DEBUG(" SolARDescriptorMatcherHammingBruteForceOpencv constructor")
 }
 
@@ -48,6 +50,7 @@ bool sortByDistanceBFM(const std::pair<int,float> &lhs, const std::pair<int,floa
 
 IDescriptorMatcher::RetCode SolARDescriptorMatcherHammingBruteForceOpencv::match(
        SRef<DescriptorBuffer> desc1,SRef<DescriptorBuffer> desc2, std::vector<DescriptorMatch>& matches){
+    SolARScopedTimer timer("SolARDescriptorMatcherHammingBruteForceOpencv::match", m_profiling != 0);
  
     // check if the descriptors type match
     if(desc1->getDescriptorType() != desc2->getDescriptorType()){
@@ -98,6 +101,7 @@ IDescriptorMatcher::RetCode SolARDescriptorMatcherHammingBruteForceOpencv::match
         std::vector<DescriptorMatch>& matches
         ) 
 { 
+    SolARScopedTimer timer("SolARDescriptorMatcherHammingBruteForceOpencv::match", m_profiling != 0);
     if (descriptors1->getNbDescriptors() ==0 || descriptors2.size()== 0)
         return IDescriptorMatcher::RetCode::DESCRIPTOR_EMPTY;
  
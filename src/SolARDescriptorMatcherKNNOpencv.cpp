@@ -15,6 +15,7 @@
  */
 
 #include "SolARDescriptorMatcherKNNOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
@@ -34,6 +35,7 @@ namespace SolAR {
         declareProperty("distanceRatio", m_distanceRatio);
         declareProperty("radius", m_radius);
         declareProperty("matchingDistanceMax", m_matchingDistanceMax);
+        declareProperty("profiling", m_profiling);
         LOG_DEBUG(" SolARDescriptorMatcherKNNOpencv constructor")
     }
 
@@ -45,6 +47,7 @@ namespace SolAR {
 
     IDescriptorMatcher::RetCode SolARDescriptorMatcherKNNOpencv::match(
                 SRef<DescriptorBuffer> desc1,SRef<DescriptorBuffer> desc2, std::vector<DescriptorMatch>& matches){
+        SolARScopedTimer timer("SolARDescriptorMatcherKNNOpencv::match", m_profiling != 0);
 
         matches.clear();
 
@@ -112,6 +115,7 @@ namespace SolAR {
                 std::vector<DescriptorMatch>& matches
                 )
     {
+        SolARScopedTimer timer("SolARDescriptorMatcherKNNOpencv::match", m_profiling != 0);
 
         matches.clear();
 
@@ -177,6 +181,7 @@ namespace SolAR {
 
 	IDescriptorMatcher::RetCode SolARDescriptorMatcherKNNOpencv::matchInRegion(const std::vector<Point2Df>& points2D, const std::vector<SRef<DescriptorBuffer>>& descriptors, const SRef<Frame> frame, std::vector<DescriptorMatch>& matches, const float radius, const float matchingDistanceMax)
 	{
+		SolARScopedTimer timer("SolARDescriptorMatcherKNNOpencv::matchInRegion", m_profiling != 0);
 		matches.clear();
 		float radiusValue = radius > 0 ? radius : m_radius;
 		float matchingDistanceMaxValue = matchingDistanceMax > 0 ? matchingDistanceMax : m_matchingDistanceMax;
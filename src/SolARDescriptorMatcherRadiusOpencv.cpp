@@ -15,6 +15,7 @@
  */
 
 #include "SolARDescriptorMatcherRadiusOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
@@ -32,6 +33,7 @@ namespace SolAR {
     {
         declareInterface<IDescriptorMatcher>(this);
         declareProperty("maxDistance", m_maxDistance);
+        declareProperty("profiling", m_profiling);
         LOG_DEBUG(" SolARDescriptorMatcherRadiusOpencv constructor")
     }
 
@@ -45,6 +47,7 @@ namespace SolAR {
                 SRef<DescriptorBuffer> desc2,
                 std::vector<DescriptorMatch>& matches)
     {
+        SolARScopedTimer timer("SolARDescriptorMatcherRadiusOpencv::match", m_profiling != 0);
 
         // check if the descriptors type match
         
@@ -104,6 +107,7 @@ namespace SolAR {
                 std::vector<DescriptorMatch> & matches
                 )
     {
+        SolARScopedTimer timer("SolARDescriptorMatcherRadiusOpencv::match", m_profiling != 0);
         if (descriptors1->getNbDescriptors() ==0 || descriptors2.size()== 0){
             return IDescriptorMatcher::RetCode::DESCRIPTOR_EMPTY;
         }
@@ -15,6 +15,7 @@
  */
 
 #include "SolARDescriptorsExtractorAKAZE2Opencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolARImageConvertorOpencv.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
@@ -39,6 +40,7 @@ SolARDescriptorsExtractorAKAZE2Opencv::SolARDescriptorsExtractorAKAZE2Opencv():C
     // m_extractor must have a default implementation : initialize default extractor type
     m_extractor=AKAZE2::create();
     declareProperty("threshold", m_threshold);
+    declareProperty("profiling", m_profiling);
 }
 
 SolARDescriptorsExtractorAKAZE2Opencv::~SolARDescriptorsExtractorAKAZE2Opencv()
@@ -57,6 +59,7 @@ xpcf::XPCFErrorCode SolARDescriptorsExtractorAKAZE2Opencv::onConfigured()
 
 void SolARDescriptorsExtractorAKAZE2Opencv::extract(const SRef<Image> image, const std::vector<Keypoint> & keypoints, SRef<DescriptorBuffer> & descriptors)
 {
+    SolARScopedTimer timer("SolARDescriptorsExtractorAKAZE2Opencv::extract", m_profiling != 0);
     //transform all SolAR data to openCv data
 
     SRef<Image> convertedImage = image;
@@ -15,6 +15,7 @@
  */
 
 #include "SolARDescriptorsExtractorAKAZEOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolARImageConvertorOpencv.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
@@ -37,6 +38,7 @@ SolARDescriptorsExtractorAKAZEOpencv::SolARDescriptorsExtractorAKAZEOpencv():Con
     // m_extractor must have a default implementation : initialize default extractor type
     m_extractor=AKAZE::create();
     declareProperty("threshold", m_threshold);
+    declareProperty("profiling", m_profiling);
 }
 
 
@@ -56,6 +58,7 @@ xpcf::XPCFErrorCode SolARDescriptorsExtractorAKAZEOpencv::onConfigured()
 
 void SolARDescriptorsExtractorAKAZEOpencv::extract(const SRef<Image> image, const std::vector<Keypoint> & keypoints, SRef<DescriptorBuffer> & descriptors)
 {
+    SolARScopedTimer timer("SolARDescriptorsExtractorAKAZEOpencv::extract", m_profiling != 0);
     //transform all SolAR data to openCv data
 
     SRef<Image> convertedImage = image;
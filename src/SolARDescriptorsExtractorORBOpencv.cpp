@@ -15,6 +15,7 @@
  */
 
 #include "SolARDescriptorsExtractorORBOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolARImageConvertorOpencv.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
@@ -42,6 +43,7 @@ SolARDescriptorsExtractorORBOpencv::SolARDescriptorsExtractorORBOpencv():Configu
     declareProperty("scoreType", m_scoreType);
     declareProperty("patchSize", m_patchSize);
     declareProperty("fastThreshold", m_fastThreshold);
+    declareProperty("profiling", m_profiling);
 
     LOG_DEBUG(" SolARDescriptorsExtractorORBOpencv constructor")
 }
@@ -70,6 +72,7 @@ SolARDescriptorsExtractorORBOpencv::~SolARDescriptorsExtractorORBOpencv()
 
 void SolARDescriptorsExtractorORBOpencv::extract(const SRef<Image> image, const std::vector<Keypoint > &keypoints, SRef<DescriptorBuffer>& descriptors)
 {
+    SolARScopedTimer timer("SolARDescriptorsExtractorORBOpencv::extract", m_profiling != 0);
     //transform all SolAR data to openCv data
 
     SRef<Image> convertedImage = image;
@@ -17,6 +17,8 @@
 #include "SolARDescriptorsExtractorSBPatternOpencv.h"
 #include "SolAROpenCVHelper.h"
 
+#include <algorithm>
+
 namespace xpcf = org::bcom::xpcf;
 XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARDescriptorsExtractorSBPatternOpencv)
 
@@ -55,122 +57,107 @@ namespace OPENCV {
                                                                           std::vector<Contour2Df> & recognized_contours)
     {
         recognized_contours.clear();
+        int descriptor_size = m_patternSize * m_patternSize;
+
+        // decode all the candidate patches, the border check and the payload are read in the same pass
         std::vector<size_t> recognizedPatterns;
-        size_t i;
-        for (i = 0; i < inputImages.size(); i++)
+        m_patterns.resize(inputImages.size() * descriptor_size);
+        for (size_t i = 0; i < inputImages.size(); i++)
         {
-            if (isPattern(inputImages[i]))
+            if (inputImages[i] && decodePattern(SolAROpenCVHelper::mapToOpenCV(inputImages[i]), m_patternSize, m_patterns.data() + recognizedPatterns.size() * descriptor_size, m_cellCounts))
                 recognizedPatterns.push_back(i);
         }
-        if (recognizedPatterns.size()== 0)
-        {
-            pattern_descriptors = xpcf::utils::make_shared<DescriptorBuffer>(DescriptorType::SBPATTERN, DescriptorDataType::TYPE_8U, m_patternSize*m_patternSize, 0);
-            return FrameworkReturnCode::_SUCCESS;
-        }
 
-        pattern_descriptors = xpcf::utils::make_shared<DescriptorBuffer>(DescriptorType::SBPATTERN, DescriptorDataType::TYPE_8U, m_patternSize*m_patternSize, static_cast<uint32_t>(recognizedPatterns.size()*4));
-        int descriptor_size = pattern_descriptors->getDescriptorByteSize();
+        pattern_descriptors = xpcf::utils::make_shared<DescriptorBuffer>(DescriptorType::SBPATTERN, DescriptorDataType::TYPE_8U, descriptor_size, static_cast<uint32_t>(recognizedPatterns.size()*4));
+        if (recognizedPatterns.size() == 0)
+            return FrameworkReturnCode::_SUCCESS;
 
-        for (i = 0; i < recognizedPatterns.size(); i++)
+        recognized_contours.reserve(recognizedPatterns.size() * 4);
+        for (size_t i = 0; i < recognizedPatterns.size(); i++)
         {
-            unsigned char* data = (unsigned char*)pattern_descriptors->data() + (i*4*descriptor_size);
-            if (getPatternDescriptorFromImage(inputImages[recognizedPatterns[i]], data) == FrameworkReturnCode::_SUCCESS)
-            {
-                Contour2Df recognizedContour = contours[recognizedPatterns[i]];
-                recognized_contours.push_back(recognizedContour);
-                unsigned char* descriptorDataTemp = data;
-                Contour2Df rotatedContourTemp = recognizedContour;
-                //check all possible rotations
-                for (int j = 0; j < 3; j++)
-                {
-                    // An array to store the descriptor buffer
-                     unsigned char* descriptorData = descriptorDataTemp + descriptor_size;
-
-                    // Rotate the current pattern 90° counter-clockwise to set the new rotated pattern
-                     for (int row = 0; row < m_patternSize; row++)
-                         for (int col = 0; col < m_patternSize; col++)
-                         {
-                             descriptorData[row * m_patternSize + col] = descriptorDataTemp[(col*m_patternSize) + m_patternSize - row - 1];
-                         }
-                     // Rotate the curent contour counter-clockwise to set the new rotated contour
-                    Contour2Df rotatedContour;
-                    for (int num_point = 0; num_point <4; num_point++)
-                        rotatedContour.push_back(rotatedContourTemp[(num_point+1)%4]);
-
-                    recognized_contours.push_back(rotatedContour);
-
-                    descriptorDataTemp = descriptorData;
-                    rotatedContourTemp = rotatedContour;
-                 }
-            }
+            addPattern(m_patterns.data() + i * descriptor_size, m_patternSize, contours[recognizedPatterns[i]],
+                       (unsigned char*)pattern_descriptors->data() + (i*4*descriptor_size), recognized_contours);
         }
 
         return FrameworkReturnCode::_SUCCESS;
     }
 
-    bool SolARDescriptorsExtractorSBPatternOpencv::isPattern(const SRef<Image> image)
+    void SolARDescriptorsExtractorSBPatternOpencv::addPattern(const unsigned char* pattern, int patternSize, const Contour2Df & contour,
+                                                              unsigned char* data, std::vector<Contour2Df> & recognized_contours)
     {
-        cv::Mat cv_image = SolAROpenCVHelper::mapToOpenCV(image);
-
-        //Markers are divided in nxm regions, of which the inner n-2xm-2 belongs to pattern info
-        //We check here if the external border is entirely black
-
-        int cellWidth = image->getWidth() / (m_patternSize+2);
-        int cellHeight = image->getHeight() / (m_patternSize+2);
-
-        for (int y = 0; y < m_patternSize+2; y++)
-        {
-            int inc = m_patternSize+1;
-
-            if (y == 0 || y == m_patternSize+1) inc = 1; //for first and last row, check the whole border
-
-            for (int x = 0; x<m_patternSize+2; x += inc)
+        int descriptor_size = patternSize * patternSize;
+        unsigned char* rotation90 = data + descriptor_size;
+        unsigned char* rotation180 = rotation90 + descriptor_size;
+        unsigned char* rotation270 = rotation180 + descriptor_size;
+
+        // Write the pattern and its three successive 90° counter-clockwise rotations from the decoded pattern
+        for (int row = 0; row < patternSize; row++)
+            for (int col = 0; col < patternSize; col++)
             {
-                int cellX = x * cellWidth;
-                int cellY = y * cellHeight;
-                cv::Mat cell = cv_image(cv::Rect(cellX, cellY, cellWidth, cellHeight));
-
-                int nZ = cv::countNonZero(cell);
-
-                if (nZ >(cellWidth*cellHeight) / 2)
-                {
-                    return false; //can not be a marker because the border element is not black!
-                }
+                int index = row * patternSize + col;
+                data[index] = pattern[index];
+                rotation90[index] = pattern[col * patternSize + patternSize - row - 1];
+                rotation180[index] = pattern[(patternSize - row - 1) * patternSize + patternSize - col - 1];
+                rotation270[index] = pattern[(patternSize - col - 1) * patternSize + row];
             }
+
+        // Rotate the contour counter-clockwise accordingly
+        recognized_contours.push_back(contour);
+        for (int j = 1; j < 4; j++)
+        {
+            Contour2Df rotatedContour;
+            for (int num_point = 0; num_point < 4; num_point++)
+                rotatedContour.push_back(contour[(num_point + j) % 4]);
+            recognized_contours.push_back(rotatedContour);
         }
-        return true;
     }
 
-    FrameworkReturnCode SolARDescriptorsExtractorSBPatternOpencv::getPatternDescriptorFromImage (SRef<Image> image, unsigned char* data)
+    bool SolARDescriptorsExtractorSBPatternOpencv::decodePattern(const cv::Mat & cv_image, int patternSize, unsigned char* data, std::vector<int> & cellCounts)
     {
-        cv::Mat cv_image = SolAROpenCVHelper::mapToOpenCV(image);
-        //cv::imshow("Recognized Pattern", grey);
-
         //Markers are divided in nxm regions, of which the inner n-2xm-2 belongs to pattern info
-        //We check here if the external border is entirely black
+        //The image is read once, one row of cells after the other. The external border must be entirely black,
+        //so the patch is rejected as soon as a completed border cell has a majority of white pixels
 
-        int cellWidth = image->getWidth() / (m_patternSize+2);
-        int cellHeight = image->getHeight() / (m_patternSize+2);
+        int nbCells = patternSize + 2;
+        int cellWidth = cv_image.cols / nbCells;
+        int cellHeight = cv_image.rows / nbCells;
+        int halfCellArea = (cellWidth * cellHeight) / 2;
+        cellCounts.resize(nbCells);
 
-        //get information(for each inner square, determine if it is  black or white)
-        for (int y = 0; y<m_patternSize; y++)
+        for (int y = 0; y < nbCells; y++)
         {
-            for (int x = 0; x<m_patternSize; x++)
+            // Count the white pixels of each cell of this row of cells
+            std::fill(cellCounts.begin(), cellCounts.end(), 0);
+            for (int pixelY = y * cellHeight; pixelY < (y + 1) * cellHeight; pixelY++)
             {
-                uint32_t cellX = (x + 1)*cellWidth;
-                uint32_t cellY = (y + 1)*cellHeight;
-                cv::Mat cell = cv_image(cv::Rect(cellX, cellY, cellWidth, cellHeight));
-
-                // Check the number of white pixels in the cell.
-                int nZ = cv::countNonZero(cell);
-                //If there is a majority of white pixels, set the matrix value to 1, else to 0
-                if (nZ>(cellWidth*cellHeight) / 2)
-                    data[m_patternSize*y+x] = (unsigned char)1;
-                else
-                    data[m_patternSize*y+x] = (unsigned char)0;
+                const uchar* row = cv_image.ptr<uchar>(pixelY);
+                for (int x = 0; x < nbCells; x++)
+                {
+                    const uchar* cell = row + x * cellWidth;
+                    int nZ = 0;
+                    for (int k = 0; k < cellWidth; k++)
+                        nZ += cell[k] != 0;
+                    cellCounts[x] += nZ;
+                }
+            }
+
+            if (y == 0 || y == nbCells - 1)
+            {
+                //for first and last row, check the whole border
+                for (int x = 0; x < nbCells; x++)
+                    if (cellCounts[x] > halfCellArea)
+                        return false; //can not be a marker because the border element is not black!
+                continue;
             }
+            if (cellCounts[0] > halfCellArea || cellCounts[nbCells - 1] > halfCellArea)
+                return false;
+
+            //If there is a majority of white pixels in an inner cell, set the matrix value to 1, else to 0
+            unsigned char* patternRow = data + patternSize * (y - 1);
+            for (int x = 1; x < nbCells - 1; x++)
+                patternRow[x - 1] = cellCounts[x] > halfCellArea ? 1 : 0;
         }
-        return FrameworkReturnCode::_SUCCESS;
+        return true;
     }
 
 }
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "SolARDescriptorsExtractorSIFTOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolARImageConvertorOpencv.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
@@ -45,6 +46,7 @@ SolARDescriptorsExtractorSIFTOpencv::SolARDescriptorsExtractorSIFTOpencv():Confi
     declareProperty("contrastThreshold", m_contrastThreshold);
     declareProperty("edgeThreshold", m_edgeThreshold);
     declareProperty("sigma", m_sigma);
+    declareProperty("profiling", m_profiling);
 }
 
 xpcf::XPCFErrorCode SolARDescriptorsExtractorSIFTOpencv::onConfigured()
@@ -60,6 +62,7 @@ SolARDescriptorsExtractorSIFTOpencv::~SolARDescriptorsExtractorSIFTOpencv()
 }
 
 void SolARDescriptorsExtractorSIFTOpencv::extract(const SRef<Image> image, const std::vector<Keypoint> & keypoints, SRef<DescriptorBuffer>& descriptors){
+    SolARScopedTimer timer("SolARDescriptorsExtractorSIFTOpencv::extract", m_profiling != 0);
 
 
     //transform all SolAR data to openCv data
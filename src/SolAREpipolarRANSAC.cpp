@@ -0,0 +1,467 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SolAREpipolarRANSAC.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+namespace {
+
+// number of least squares refinements of a new best model
+const int NB_LOCAL_OPTIMIZATIONS = 4;
+// number of correspondences of the linear least squares solver
+const int NB_POINTS_LEAST_SQUARES = 8;
+
+typedef Eigen::Matrix<double, 9, 1> Vector9d;
+
+// coefficients of the epipolar constraint [x2 y2 1] M [x1 y1 1]' = 0 for the row-major entries of M
+inline Vector9d epipolarConstraint(double x1, double y1, double x2, double y2)
+{
+    Vector9d row;
+    row << x2 * x1, x2 * y1, x2, y2 * x1, y2 * y1, y2, x1, y1, 1.;
+    return row;
+}
+
+inline Eigen::Matrix3d toMatrix(const Vector9d & vec)
+{
+    Eigen::Matrix3d mat;
+    mat << vec(0), vec(1), vec(2),
+           vec(3), vec(4), vec(5),
+           vec(6), vec(7), vec(8);
+    return mat;
+}
+
+// Hartley normalization: translates the centroid to the origin and scales the mean distance to sqrt(2)
+template <class Indices>
+void normalization(const std::vector<float> & xs, const std::vector<float> & ys, const Indices & indices, int nbIndices, Eigen::Matrix3d & T)
+{
+    double cx = 0., cy = 0.;
+    for (int i = 0; i < nbIndices; ++i) {
+        cx += xs[indices[i]];
+        cy += ys[indices[i]];
+    }
+    cx /= nbIndices;
+    cy /= nbIndices;
+    double meanDist = 0.;
+    for (int i = 0; i < nbIndices; ++i)
+        meanDist += std::hypot(xs[indices[i]] - cx, ys[indices[i]] - cy);
+    meanDist /= nbIndices;
+    double scale = meanDist > std::numeric_limits<double>::epsilon() ? std::sqrt(2.) / meanDist : 1.;
+    T << scale, 0., -scale * cx,
+         0., scale, -scale * cy,
+         0., 0., 1.;
+}
+
+// real roots of the polynomial sum(coeffs[i] * t^i), computed as the eigenvalues of its companion matrix
+std::vector<double> realRoots(std::vector<double> coeffs)
+{
+    std::vector<double> roots;
+    while (!coeffs.empty() && std::abs(coeffs.back()) < 1e-12)
+        coeffs.pop_back();
+    int degree = static_cast<int>(coeffs.size()) - 1;
+    if (degree < 1)
+        return roots;
+    Eigen::MatrixXd companion = Eigen::MatrixXd::Zero(degree, degree);
+    for (int i = 0; i < degree; ++i)
+        companion(0, i) = -coeffs[degree - 1 - i] / coeffs[degree];
+    for (int i = 1; i < degree; ++i)
+        companion(i, i - 1) = 1.;
+    Eigen::EigenSolver<Eigen::MatrixXd> solver(companion, false);
+    for (int i = 0; i < degree; ++i)
+        if (std::abs(solver.eigenvalues()(i).imag()) < 1e-10)
+            roots.push_back(solver.eigenvalues()(i).real());
+    return roots;
+}
+
+// 7-point algorithm: F = a * F1 + (1 - a) * F2 with det(F) = 0
+int sevenPoints(const EpipolarCorrespondences & c, const int * sample, std::vector<Eigen::Matrix3d> & models)
+{
+    Eigen::Matrix3d T1, T2;
+    normalization(c.x1, c.y1, sample, 7, T1);
+    normalization(c.x2, c.y2, sample, 7, T2);
+    Eigen::Matrix<double, 9, 9> A = Eigen::Matrix<double, 9, 9>::Zero();
+    for (int i = 0; i < 7; ++i) {
+        Eigen::Vector3d p1 = T1 * Eigen::Vector3d(c.x1[sample[i]], c.y1[sample[i]], 1.);
+        Eigen::Vector3d p2 = T2 * Eigen::Vector3d(c.x2[sample[i]], c.y2[sample[i]], 1.);
+        A.row(i) = epipolarConstraint(p1(0), p1(1), p2(0), p2(1)).transpose();
+    }
+    Eigen::JacobiSVD<Eigen::Matrix<double, 9, 9>> svd(A, Eigen::ComputeFullV);
+    Eigen::Matrix3d F1 = toMatrix(svd.matrixV().col(7));
+    Eigen::Matrix3d F2 = toMatrix(svd.matrixV().col(8));
+    // det(F2 + a * (F1 - F2)) is a cubic in a, interpolated from 4 values
+    Eigen::Matrix4d vandermonde;
+    Eigen::Vector4d values;
+    const double samples[4] = {0., 1., -1., 2.};
+    for (int i = 0; i < 4; ++i) {
+        double a = samples[i];
+        vandermonde.row(i) << 1., a, a * a, a * a * a;
+        values(i) = (F2 + a * (F1 - F2)).determinant();
+    }
+    Eigen::Vector4d coeffs = vandermonde.lu().solve(values);
+    models.clear();
+    for (double a : realRoots({coeffs(0), coeffs(1), coeffs(2), coeffs(3)}))
+        models.push_back(T2.transpose() * (F2 + a * (F1 - F2)) * T1);
+    return static_cast<int>(models.size());
+}
+
+// Polynomial of degree 3 at most in x, y, z. Monomials are sorted in graded reverse lexicographic order,
+// so that the 10 cubic monomials come first, followed by x^2, xy, xz, y^2, yz, z^2, x, y, z, 1.
+struct Poly3 {
+    std::array<double, 20> c;
+
+    Poly3() { c.fill(0.); }
+
+    static int index(int ex, int ey, int ez)
+    {
+        static const int table[4][4][4] = {
+            // ex = 0: [ey][ez]
+            {{19, 18, 15, 9}, {17, 14, 8, -1}, {13, 7, -1, -1}, {6, -1, -1, -1}},
+            // ex = 1
+            {{16, 12, 5, -1}, {11, 4, -1, -1}, {3, -1, -1, -1}, {-1, -1, -1, -1}},
+            // ex = 2
+            {{10, 2, -1, -1}, {1, -1, -1, -1}, {-1, -1, -1, -1}, {-1, -1, -1, -1}},
+            // ex = 3
+            {{0, -1, -1, -1}, {-1, -1, -1, -1}, {-1, -1, -1, -1}, {-1, -1, -1, -1}}};
+        return table[ex][ey][ez];
+    }
+
+    static const std::array<std::array<int, 3>, 20> & exponents()
+    {
+        static const std::array<std::array<int, 3>, 20> exps = {{
+            {{3, 0, 0}}, {{2, 1, 0}}, {{2, 0, 1}}, {{1, 2, 0}}, {{1, 1, 1}}, {{1, 0, 2}}, {{0, 3, 0}}, {{0, 2, 1}}, {{0, 1, 2}}, {{0, 0, 3}},
+            {{2, 0, 0}}, {{1, 1, 0}}, {{1, 0, 1}}, {{0, 2, 0}}, {{0, 1, 1}}, {{0, 0, 2}}, {{1, 0, 0}}, {{0, 1, 0}}, {{0, 0, 1}}, {{0, 0, 0}}}};
+        return exps;
+    }
+
+    Poly3 operator+(const Poly3 & other) const { Poly3 res; for (int i = 0; i < 20; ++i) res.c[i] = c[i] + other.c[i]; return res; }
+    Poly3 operator-(const Poly3 & other) const { Poly3 res; for (int i = 0; i < 20; ++i) res.c[i] = c[i] - other.c[i]; return res; }
+    Poly3 operator*(double s) const { Poly3 res; for (int i = 0; i < 20; ++i) res.c[i] = c[i] * s; return res; }
+
+    // the product must be of degree 3 at most
+    Poly3 operator*(const Poly3 & other) const
+    {
+        const auto & exps = exponents();
+        Poly3 res;
+        for (int i = 0; i < 20; ++i) {
+            if (c[i] == 0.)
+                continue;
+            for (int j = 0; j < 20; ++j) {
+                if (other.c[j] == 0.)
+                    continue;
+                int idx = index(exps[i][0] + exps[j][0], exps[i][1] + exps[j][1], exps[i][2] + exps[j][2]);
+                res.c[idx] += c[i] * other.c[j];
+            }
+        }
+        return res;
+    }
+};
+
+// 5-point algorithm of Stewenius et al. (Recent developments on direct relative orientation, 2006)
+int fivePoints(const EpipolarCorrespondences & c, const int * sample, std::vector<Eigen::Matrix3d> & models)
+{
+    models.clear();
+    // null space of the epipolar constraints: E = x X + y Y + z Z + W
+    Eigen::Matrix<double, 9, 9> A = Eigen::Matrix<double, 9, 9>::Zero();
+    for (int i = 0; i < 5; ++i)
+        A.row(i) = epipolarConstraint(c.x1[sample[i]], c.y1[sample[i]], c.x2[sample[i]], c.y2[sample[i]]).transpose();
+    Eigen::JacobiSVD<Eigen::Matrix<double, 9, 9>> svd(A, Eigen::ComputeFullV);
+    Eigen::Matrix<double, 9, 4> basis = svd.matrixV().rightCols<4>();
+
+    // E as a matrix of polynomials of degree 1
+    Poly3 E[3][3];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) {
+            E[i][j].c[Poly3::index(1, 0, 0)] = basis(3 * i + j, 0);
+            E[i][j].c[Poly3::index(0, 1, 0)] = basis(3 * i + j, 1);
+            E[i][j].c[Poly3::index(0, 0, 1)] = basis(3 * i + j, 2);
+            E[i][j].c[Poly3::index(0, 0, 0)] = basis(3 * i + j, 3);
+        }
+
+    // cubic constraints: det(E) = 0 and 2 E E' E - trace(E E') E = 0
+    Eigen::Matrix<double, 10, 20> M;
+    Poly3 det = E[0][0] * (E[1][1] * E[2][2] - E[1][2] * E[2][1])
+              - E[0][1] * (E[1][0] * E[2][2] - E[1][2] * E[2][0])
+              + E[0][2] * (E[1][0] * E[2][1] - E[1][1] * E[2][0]);
+    for (int k = 0; k < 20; ++k)
+        M(0, k) = det.c[k];
+    Poly3 EEt[3][3];
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            EEt[i][j] = E[i][0] * E[j][0] + E[i][1] * E[j][1] + E[i][2] * E[j][2];
+    Poly3 halfTrace = (EEt[0][0] + EEt[1][1] + EEt[2][2]) * 0.5;
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j) {
+            Poly3 eq = (EEt[i][0] - (i == 0 ? halfTrace : Poly3())) * E[0][j]
+                     + (EEt[i][1] - (i == 1 ? halfTrace : Poly3())) * E[1][j]
+                     + (EEt[i][2] - (i == 2 ? halfTrace : Poly3())) * E[2][j];
+            for (int k = 0; k < 20; ++k)
+                M(1 + 3 * i + j, k) = eq.c[k];
+        }
+
+    // Gauss-Jordan elimination of the cubic monomials: cubic_i = - sum_j C(i, j) * basis_j
+    Eigen::FullPivLU<Eigen::Matrix<double, 10, 10>> lu(M.leftCols<10>());
+    if (!lu.isInvertible())
+        return 0;
+    Eigen::Matrix<double, 10, 10> C = lu.solve(M.rightCols<10>());
+
+    // action matrix of the multiplication by x on the basis x^2, xy, xz, y^2, yz, z^2, x, y, z, 1
+    Eigen::Matrix<double, 10, 10> action = Eigen::Matrix<double, 10, 10>::Zero();
+    for (int k = 0; k < 6; ++k)
+        action.row(k) = -C.row(k);  // x * (x^2, xy, xz, y^2, yz, z^2) = x^3, x^2y, x^2z, xy^2, xyz, xz^2
+    action(6, 0) = 1.;  // x * x = x^2
+    action(7, 1) = 1.;  // x * y = xy
+    action(8, 2) = 1.;  // x * z = xz
+    action(9, 6) = 1.;  // x * 1 = x
+
+    Eigen::EigenSolver<Eigen::Matrix<double, 10, 10>> solver(action);
+    for (int k = 0; k < 10; ++k) {
+        if (std::abs(solver.eigenvalues()(k).imag()) > 1e-10)
+            continue;
+        Eigen::Matrix<double, 10, 1> v = solver.eigenvectors().col(k).real();
+        if (std::abs(v(9)) < std::numeric_limits<double>::epsilon())
+            continue;
+        double x = v(6) / v(9), y = v(7) / v(9), z = v(8) / v(9);
+        Vector9d e = x * basis.col(0) + y * basis.col(1) + z * basis.col(2) + basis.col(3);
+        models.push_back(toMatrix(e.normalized()));
+    }
+    return static_cast<int>(models.size());
+}
+
+}
+
+SolAREpipolarRANSAC::SolAREpipolarRANSAC(Model model, float threshold, float confidence, int maxIterations) :
+    m_model(model), m_threshold(threshold), m_confidence(confidence), m_maxIterations(maxIterations)
+{
+}
+
+int SolAREpipolarRANSAC::scoreSampson(const Eigen::Matrix3d & matrix, const EpipolarCorrespondences & correspondences, float threshold2, float * errors, float & score)
+{
+    const float f00 = static_cast<float>(matrix(0, 0)), f01 = static_cast<float>(matrix(0, 1)), f02 = static_cast<float>(matrix(0, 2));
+    const float f10 = static_cast<float>(matrix(1, 0)), f11 = static_cast<float>(matrix(1, 1)), f12 = static_cast<float>(matrix(1, 2));
+    const float f20 = static_cast<float>(matrix(2, 0)), f21 = static_cast<float>(matrix(2, 1)), f22 = static_cast<float>(matrix(2, 2));
+    const float *x1 = correspondences.x1.data(), *y1 = correspondences.y1.data();
+    const float *x2 = correspondences.x2.data(), *y2 = correspondences.y2.data();
+    const int nbPoints = static_cast<int>(correspondences.size());
+    int nbInliers = 0;
+    float sum = 0.f;
+    int i = 0;
+#if CV_SIMD
+    {
+        const int step = cv::v_float32::nlanes;
+        const cv::v_float32 vf00 = cv::vx_setall_f32(f00), vf01 = cv::vx_setall_f32(f01), vf02 = cv::vx_setall_f32(f02);
+        const cv::v_float32 vf10 = cv::vx_setall_f32(f10), vf11 = cv::vx_setall_f32(f11), vf12 = cv::vx_setall_f32(f12);
+        const cv::v_float32 vf20 = cv::vx_setall_f32(f20), vf21 = cv::vx_setall_f32(f21), vf22 = cv::vx_setall_f32(f22);
+        const cv::v_float32 vthreshold = cv::vx_setall_f32(threshold2), vone = cv::vx_setall_f32(1.f), vzero = cv::vx_setzero_f32();
+        cv::v_float32 vsum = vzero, vcount = vzero;
+        for (; i <= nbPoints - step; i += step) {
+            cv::v_float32 vx1 = cv::vx_load(x1 + i), vy1 = cv::vx_load(y1 + i);
+            cv::v_float32 vx2 = cv::vx_load(x2 + i), vy2 = cv::vx_load(y2 + i);
+            // M * p1 and M' * p2
+            cv::v_float32 a = cv::v_fma(vf00, vx1, cv::v_fma(vf01, vy1, vf02));
+            cv::v_float32 b = cv::v_fma(vf10, vx1, cv::v_fma(vf11, vy1, vf12));
+            cv::v_float32 c = cv::v_fma(vf20, vx1, cv::v_fma(vf21, vy1, vf22));
+            cv::v_float32 d = cv::v_fma(vf00, vx2, cv::v_fma(vf10, vy2, vf20));
+            cv::v_float32 e = cv::v_fma(vf01, vx2, cv::v_fma(vf11, vy2, vf21));
+            cv::v_float32 r = cv::v_fma(vx2, a, cv::v_fma(vy2, b, c));
+            cv::v_float32 err = (r * r) / (a * a + b * b + d * d + e * e);
+            if (errors)
+                cv::v_store(errors + i, err);
+            // a NaN error (degenerate point) is neither counted nor accumulated above the threshold
+            vcount += cv::v_select(err < vthreshold, vone, vzero);
+            vsum += cv::v_min(err, vthreshold);
+        }
+        sum = cv::v_reduce_sum(vsum);
+        nbInliers = static_cast<int>(cv::v_reduce_sum(vcount) + 0.5f);
+        cv::vx_cleanup();
+    }
+#endif
+    for (; i < nbPoints; ++i) {
+        float a = f00 * x1[i] + f01 * y1[i] + f02;
+        float b = f10 * x1[i] + f11 * y1[i] + f12;
+        float c = f20 * x1[i] + f21 * y1[i] + f22;
+        float d = f00 * x2[i] + f10 * y2[i] + f20;
+        float e = f01 * x2[i] + f11 * y2[i] + f21;
+        float r = x2[i] * a + y2[i] * b + c;
+        float err = (r * r) / (a * a + b * b + d * d + e * e);
+        if (errors)
+            errors[i] = err;
+        if (err < threshold2) {
+            ++nbInliers;
+            sum += err;
+        }
+        else
+            sum += threshold2;
+    }
+    score = sum;
+    return nbInliers;
+}
+
+int SolAREpipolarRANSAC::solveMinimal(const EpipolarCorrespondences & correspondences, const int * sample, std::vector<Eigen::Matrix3d> & models) const
+{
+    if (m_model == Model::FUNDAMENTAL)
+        return sevenPoints(correspondences, sample, models);
+    return fivePoints(correspondences, sample, models);
+}
+
+bool SolAREpipolarRANSAC::solveLeastSquares(const EpipolarCorrespondences & correspondences, const std::vector<int> & indices, Eigen::Matrix3d & model) const
+{
+    const int nbIndices = static_cast<int>(indices.size());
+    if (nbIndices < NB_POINTS_LEAST_SQUARES)
+        return false;
+    // essential matrices are estimated on normalized correspondences and must not be normalized again
+    Eigen::Matrix3d T1 = Eigen::Matrix3d::Identity(), T2 = Eigen::Matrix3d::Identity();
+    if (m_model == Model::FUNDAMENTAL) {
+        normalization(correspondences.x1, correspondences.y1, indices, nbIndices, T1);
+        normalization(correspondences.x2, correspondences.y2, indices, nbIndices, T2);
+    }
+    // normal equations of the 8-point algorithm
+    Eigen::Matrix<double, 9, 9> AtA = Eigen::Matrix<double, 9, 9>::Zero();
+    for (int idx : indices) {
+        double x1 = T1(0, 0) * correspondences.x1[idx] + T1(0, 2), y1 = T1(1, 1) * correspondences.y1[idx] + T1(1, 2);
+        double x2 = T2(0, 0) * correspondences.x2[idx] + T2(0, 2), y2 = T2(1, 1) * correspondences.y2[idx] + T2(1, 2);
+        Vector9d row = epipolarConstraint(x1, y1, x2, y2);
+        AtA.selfadjointView<Eigen::Lower>().rankUpdate(row);
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double, 9, 9>> eigenSolver(AtA.selfadjointView<Eigen::Lower>());
+    if (eigenSolver.info() != Eigen::Success)
+        return false;
+    Eigen::Matrix3d M = toMatrix(eigenSolver.eigenvectors().col(0));
+    // projection on the set of fundamental (rank 2) or essential (two equal singular values) matrices
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd(M, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    Eigen::Vector3d singularValues = svd.singularValues();
+    if (m_model == Model::ESSENTIAL) {
+        double s = (singularValues(0) + singularValues(1)) * 0.5;
+        singularValues << s, s, 0.;
+    }
+    else
+        singularValues(2) = 0.;
+    M = svd.matrixU() * singularValues.asDiagonal() * svd.matrixV().transpose();
+    model = T2.transpose() * M * T1;
+    return true;
+}
+
+void SolAREpipolarRANSAC::localOptimization(const EpipolarCorrespondences & correspondences, Eigen::Matrix3d & model, float & score, int & nbInliers, std::vector<float> & errors) const
+{
+    const float threshold2 = m_threshold * m_threshold;
+    std::vector<int> inlierIndices;
+    std::vector<float> candidateErrors(errors.size());
+    for (int iter = 0; iter < NB_LOCAL_OPTIMIZATIONS; ++iter) {
+        inlierIndices.clear();
+        for (int i = 0; i < static_cast<int>(errors.size()); ++i)
+            if (errors[i] < threshold2)
+                inlierIndices.push_back(i);
+        Eigen::Matrix3d candidate;
+        if (!solveLeastSquares(correspondences, inlierIndices, candidate))
+            return;
+        float candidateScore;
+        int candidateNbInliers = scoreSampson(candidate, correspondences, threshold2, candidateErrors.data(), candidateScore);
+        if (candidateScore >= score)
+            return;
+        model = candidate;
+        score = candidateScore;
+        nbInliers = candidateNbInliers;
+        errors.swap(candidateErrors);
+    }
+}
+
+bool SolAREpipolarRANSAC::estimate(const EpipolarCorrespondences & correspondences, Eigen::Matrix3d & matrix, std::vector<uint8_t> & inliers) const
+{
+    const int nbPoints = static_cast<int>(correspondences.size());
+    const int sampleSize = m_model == Model::FUNDAMENTAL ? 7 : 5;
+    inliers.assign(nbPoints, 0);
+    if (nbPoints < sampleSize)
+        return false;
+
+    const float threshold2 = m_threshold * m_threshold;
+    // fixed seed, the estimation is reproducible
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> uniform(0, nbPoints - 1);
+    std::vector<Eigen::Matrix3d> models;
+    std::vector<float> errors(nbPoints), bestErrors(nbPoints);
+    Eigen::Matrix3d bestModel;
+    float bestScore = std::numeric_limits<float>::max();
+    int bestNbInliers = 0;
+    int nbIterations = m_maxIterations;
+    int sample[7];
+
+    for (int iter = 0; iter < nbIterations; ++iter) {
+        // draw a minimal sample of distinct correspondences
+        for (int k = 0; k < sampleSize; ++k) {
+            bool isDuplicate;
+            do {
+                sample[k] = uniform(rng);
+                isDuplicate = false;
+                for (int l = 0; l < k; ++l)
+                    isDuplicate |= (sample[l] == sample[k]);
+            } while (isDuplicate);
+        }
+        solveMinimal(correspondences, sample, models);
+        bool isImproved = false;
+        for (const auto & model : models) {
+            float score;
+            int nbInliers = scoreSampson(model, correspondences, threshold2, errors.data(), score);
+            if (score < bestScore) {
+                bestScore = score;
+                bestNbInliers = nbInliers;
+                bestModel = model;
+                bestErrors.swap(errors);
+                isImproved = true;
+            }
+        }
+        if (!isImproved)
+            continue;
+        localOptimization(correspondences, bestModel, bestScore, bestNbInliers, bestErrors);
+        // adapt the number of iterations to the inlier ratio
+        double inlierRatio = static_cast<double>(bestNbInliers) / nbPoints;
+        double allInliersProbability = std::pow(inlierRatio, sampleSize);
+        if (allInliersProbability >= 1. - std::numeric_limits<double>::epsilon())
+            break;
+        // log1p keeps the precision of a tiny probability, which gives no bound on the number of iterations
+        double logNoOutlierProbability = std::log1p(-allInliersProbability);
+        if (!std::isfinite(logNoOutlierProbability) || logNoOutlierProbability >= 0.)
+            continue;
+        double requiredIterations = std::log(1. - m_confidence) / logNoOutlierProbability;
+        if (std::isfinite(requiredIterations) && requiredIterations > 0. && requiredIterations < nbIterations)
+            nbIterations = std::min(nbIterations, static_cast<int>(std::ceil(requiredIterations)));
+    }
+
+    if (bestNbInliers < sampleSize)
+        return false;
+    for (int i = 0; i < nbPoints; ++i)
+        inliers[i] = bestErrors[i] < threshold2 ? 1 : 0;
+    if ((m_model == Model::FUNDAMENTAL) && (std::abs(bestModel(2, 2)) > std::numeric_limits<double>::epsilon()))
+        bestModel /= bestModel(2, 2);
+    else
+        bestModel.normalize();
+    matrix = bestModel;
+    return true;
+}
+
+}
+}
+}
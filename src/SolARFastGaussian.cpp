@@ -0,0 +1,104 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SolARFastGaussian.h"
+
+#include "opencv2/imgproc.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+namespace {
+
+// the number of stacked box filters, the profile of three boxes is close to a Gaussian
+const int NB_BOXES = 3;
+// the smallest standard deviation approximated by the box filters
+const float MIN_BOX_SIGMA = 2.f;
+// the scale of the 8 bits images filtered in fixed point
+const double FIXED_POINT_SCALE = 256.;
+
+}
+
+void SolARFastGaussian::boxWidths(float sigma, int nbBoxes, std::vector<int> & widths)
+{
+    // the variance of a box of width w is (w * w - 1) / 12, m boxes of width wl and the others of width wl + 2 are the closest to 12 * sigma * sigma
+    float variance12 = 12.f * sigma * sigma;
+    int wl = static_cast<int>(std::floor(std::sqrt(variance12 / nbBoxes + 1.f)));
+    if (wl % 2 == 0)
+        wl--;
+    wl = std::max(wl, 1);
+    int m = static_cast<int>(std::round((variance12 - nbBoxes * wl * wl - 4 * nbBoxes * wl - 3 * nbBoxes) / (-4.f * wl - 4.f)));
+    m = std::min(std::max(m, 0), nbBoxes);
+    widths.resize(nbBoxes);
+    for (int i = 0; i < nbBoxes; i++)
+        widths[i] = i < m ? wl : wl + 2;
+}
+
+void SolARFastGaussian::blur(const cv::Mat & src, cv::Mat & dst, cv::Size ksize, float sigmaX, float sigmaY, int borderType)
+{
+    CV_Assert(src.depth() == CV_8U || src.depth() == CV_32F);
+    if (sigmaY <= 0.f)
+        sigmaY = sigmaX;
+    if (sigmaX < MIN_BOX_SIGMA || sigmaY < MIN_BOX_SIGMA)
+    {
+        cv::GaussianBlur(src, dst, ksize, sigmaX, sigmaY, borderType);
+        return;
+    }
+
+    std::vector<int> widthsX, widthsY;
+    boxWidths(sigmaX, NB_BOXES, widthsX);
+    boxWidths(sigmaY, NB_BOXES, widthsY);
+    // a band is filtered with the rows around it that the successive boxes read
+    int margin = 0;
+    for (int width : widthsY)
+        margin += width / 2;
+
+    // the bands read rows that the other bands write
+    cv::Mat source = src.data == dst.data ? src.clone() : src;
+    dst.create(src.size(), src.type());
+    bool fixedPoint = src.depth() == CV_8U;
+    int workType = fixedPoint ? CV_MAKETYPE(CV_16U, src.channels()) : src.type();
+
+    cv::parallel_for_(cv::Range(0, source.rows), [&](const cv::Range & range) {
+        int a = std::max(range.start - margin, 0);
+        int b = std::min(range.end + margin, source.rows);
+        // the rows of the margin are wrong after the boxes, except at the border of the image, but are not used
+        cv::Mat work[2];
+        cv::Mat input = source.rowRange(a, b);
+        int current = 0;
+        if (fixedPoint)
+        {
+            input.convertTo(work[current], workType, FIXED_POINT_SCALE);
+            input = work[current];
+        }
+        for (int i = 0; i < NB_BOXES; i++)
+        {
+            current = 1 - current;
+            cv::boxFilter(input, work[current], -1, cv::Size(widthsX[i], widthsY[i]), cv::Point(-1, -1), true, borderType);
+            input = work[current];
+        }
+        cv::Mat dstBand = dst.rowRange(range.start, range.end);
+        input.rowRange(range.start - a, range.end - a).convertTo(dstBand, dst.type(), fixedPoint ? 1. / FIXED_POINT_SCALE : 1.);
+    }, cv::getNumThreads());
+}
+
+}
+}
+}
@@ -0,0 +1,172 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SolARFiducialMarkerDetectorOpencv.h"
+#include "SolARLatencyProfiler.h"
+#include "SolAROpenCVHelper.h"
+#include "SolARContoursFilterBinaryMarkerOpencv.h"
+#include "SolARDescriptorsExtractorSBPatternOpencv.h"
+#include "SolARImageFilterAdaptiveBinaryOpencv.h"
+#include "core/Log.h"
+
+#include "opencv2/imgproc.hpp"
+
+#include <algorithm>
+
+namespace xpcf = org::bcom::xpcf;
+XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARFiducialMarkerDetectorOpencv)
+
+namespace SolAR {
+using namespace datastructure;
+namespace MODULES {
+namespace OPENCV {
+
+SolARFiducialMarkerDetectorOpencv::SolARFiducialMarkerDetectorOpencv():ConfigurableBase(xpcf::toUUID<SolARFiducialMarkerDetectorOpencv>())
+{
+    declareInterface<IFiducialMarkerDetector>(this);
+    declareProperty("blockSize", m_blockSize);
+    declareProperty("C", m_C);
+    declareProperty("minContourEdges", m_minContourEdges);
+    declareProperty("epsilon", m_epsilon);
+    declareProperty("minContourLength", m_minContourLength);
+    declareProperty("minDistanceBetweenContourCorners", m_minDistanceBetweenContourCorners);
+    declareProperty("patternSize", m_patternSize);
+    declareProperty("cellSize", m_cellSize);
+    declareProperty("tracking", m_tracking);
+    declareProperty("roiMargin", m_roiMargin);
+    declareProperty("fullScanInterval", m_fullScanInterval);
+    declareProperty("profiling", m_profiling);
+    LOG_DEBUG("SolARFiducialMarkerDetectorOpencv constructor");
+}
+
+FrameworkReturnCode SolARFiducialMarkerDetectorOpencv::detect(const SRef<Image> image,
+                                                              SRef<DescriptorBuffer> & descriptors,
+                                                              std::vector<Contour2Df> & contours)
+{
+    SolARScopedTimer timer("SolARFiducialMarkerDetectorOpencv::detect", m_profiling != 0);
+    contours.clear();
+    if (image == nullptr)
+    {
+        LOG_ERROR("The input image of SolARFiducialMarkerDetectorOpencv is null");
+        return FrameworkReturnCode::_ERROR_;
+    }
+
+    // Grey conversion, the input image is used as is when it is already grey
+    cv::Mat cvImage = SolAROpenCVHelper::mapToOpenCV(image);
+    cv::Mat grey;
+    switch (image->getImageLayout()) {
+    case Image::ImageLayout::LAYOUT_GREY:
+        grey = cvImage;
+        break;
+    case Image::ImageLayout::LAYOUT_RGB:
+        cv::cvtColor(cvImage, m_grey, cv::COLOR_RGB2GRAY);
+        grey = m_grey;
+        break;
+    case Image::ImageLayout::LAYOUT_BGR:
+        cv::cvtColor(cvImage, m_grey, cv::COLOR_BGR2GRAY);
+        grey = m_grey;
+        break;
+    default:
+        LOG_ERROR("SolARFiducialMarkerDetectorOpencv takes only grey, RGB or BGR images as input");
+        return FrameworkReturnCode::_ERROR_;
+    }
+
+    // Search around the markers of the previous frame when tracking, and in the whole frame on loss or every fullScanInterval frames
+    cv::Rect frame(0, 0, grey.cols, grey.rows);
+    bool tracked = false;
+    if (m_tracking && !m_trackedRegion.empty() && m_nbFramesSinceFullScan < m_fullScanInterval)
+    {
+        detectInRegion(grey, m_trackedRegion & frame);
+        tracked = !m_recognized.empty();
+        m_nbFramesSinceFullScan++;
+    }
+    if (!tracked)
+    {
+        detectInRegion(grey, frame);
+        m_nbFramesSinceFullScan = 0;
+    }
+
+    int descriptorSize = m_patternSize * m_patternSize;
+    descriptors = xpcf::utils::make_shared<DescriptorBuffer>(DescriptorType::SBPATTERN, DescriptorDataType::TYPE_8U, descriptorSize, static_cast<uint32_t>(m_recognized.size() * 4));
+    contours.reserve(m_recognized.size() * 4);
+    for (size_t i = 0; i < m_recognized.size(); i++)
+        SolARDescriptorsExtractorSBPatternOpencv::addPattern(m_patterns.data() + i * descriptorSize, m_patternSize, m_markers[m_recognized[i]],
+                                                             (unsigned char*)descriptors->data() + i * 4 * descriptorSize, contours);
+
+    // The region of the next frame is the bounding box of the recognized markers, expanded to follow their motion
+    m_trackedRegion = cv::Rect();
+    if (m_tracking && !m_recognized.empty())
+    {
+        cv::Rect2f box(m_markers[m_recognized[0]][0].getX(), m_markers[m_recognized[0]][0].getY(), 0.f, 0.f);
+        for (size_t i : m_recognized)
+            for (const auto & corner : m_markers[i])
+                box |= cv::Rect2f(corner.getX(), corner.getY(), 1.f, 1.f);
+        float margin = m_roiMargin * std::max(box.width, box.height) + m_blockSize;
+        m_trackedRegion = cv::Rect(cv::Point(cvFloor(box.x - margin), cvFloor(box.y - margin)),
+                                   cv::Point(cvCeil(box.br().x + margin), cvCeil(box.br().y + margin))) & frame;
+    }
+
+    return FrameworkReturnCode::_SUCCESS;
+}
+
+void SolARFiducialMarkerDetectorOpencv::detectInRegion(const cv::Mat & grey, const cv::Rect & region)
+{
+    // Binarization and contours extraction, restricted to the region
+    SolARImageFilterAdaptiveBinaryOpencv::adaptiveThreshold(grey(region), m_binary, 255, m_blockSize, m_C);
+    cv::findContours(m_binary, m_contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+
+    // Reject the candidates on their size and their shape before any warp
+    m_candidates.clear();
+    Contour2Df quad;
+    for (const auto & contour : m_contours)
+    {
+        if (SolAROpenCVHelper::contourChainLength(contour) <= m_minContourEdges)
+            continue;
+        if (SolARContoursFilterBinaryMarkerOpencv::approximateQuad(contour, m_epsilon, m_minContourLength, quad))
+            m_candidates.push_back(quad);
+    }
+    SolARContoursFilterBinaryMarkerOpencv::removeTooNearCandidates(m_candidates, m_minDistanceBetweenContourCorners, m_markers);
+
+    // Rectify a small patch of each candidate from the binary image and decode it
+    int patchSize = (m_patternSize + 2) * m_cellSize;
+    std::vector<cv::Point2f> patchCorners = { cv::Point2f(0, 0),
+                                              cv::Point2f(patchSize - 1, 0),
+                                              cv::Point2f(patchSize - 1, patchSize - 1),
+                                              cv::Point2f(0, patchSize - 1) };
+    std::vector<cv::Point2f> corners(4);
+    int descriptorSize = m_patternSize * m_patternSize;
+    m_patterns.resize(m_markers.size() * descriptorSize);
+    m_recognized.clear();
+    for (size_t i = 0; i < m_markers.size(); i++)
+    {
+        for (int j = 0; j < 4; j++)
+            corners[j] = cv::Point2f(m_markers[i][j].getX(), m_markers[i][j].getY());
+        cv::Mat markerTransform = cv::getPerspectiveTransform(corners, patchCorners);
+        cv::warpPerspective(m_binary, m_patch, markerTransform, cv::Size(patchSize, patchSize));
+        if (SolARDescriptorsExtractorSBPatternOpencv::decodePattern(m_patch, m_patternSize, m_patterns.data() + m_recognized.size() * descriptorSize, m_cellCounts))
+            m_recognized.push_back(i);
+    }
+
+    // Express the corners in the frame
+    if (region.x != 0 || region.y != 0)
+        for (auto & marker : m_markers)
+            for (auto & corner : marker)
+                corner = Point2Df(corner.getX() + region.x, corner.getY() + region.y);
+}
+
+}
+}
+}  // end of namespace Solar
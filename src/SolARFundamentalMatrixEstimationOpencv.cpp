@@ -16,8 +16,9 @@
 
 #include "SolARFundamentalMatrixEstimationOpencv.h"
 #include "SolAROpenCVHelper.h"
+#include "SolAREpipolarRANSAC.h"
 #include "core/Log.h"
-#include "opencv2/calib3d/calib3d.hpp"
+#include <algorithm>
 
 namespace xpcf  = org::bcom::xpcf;
 
@@ -44,35 +45,23 @@ api::solver::pose::Transform2DFinder::RetCode SolARFundamentalMatrixEstimationOp
                                           const std::vector<Point2Df> & dstPoints,
                                           Transform2Df & fundamental){
 
-    cv::Mat F;
-    std::vector<cv::Point2f> points_view1;
-    std::vector<cv::Point2f> points_view2;
-
-    points_view1.resize(srcPoints.size());
-    points_view2.resize(dstPoints.size());
-
-    double minVal, maxVal;
-
-
-    std::vector<uchar>status(points_view1.size());
-
+    EpipolarCorrespondences correspondences;
+    correspondences.reserve(srcPoints.size());
+    float maxVal = 0.f;
     for( int i = 0; i < srcPoints.size(); i++ ){
-        points_view1[i].x=srcPoints.at(i).getX();
-        points_view1[i].y=srcPoints.at(i).getY();
-
-        points_view2[i].x=dstPoints.at(i).getX();
-        points_view2[i].y=dstPoints.at(i).getY();
+        correspondences.push_back(srcPoints[i].getX(), srcPoints[i].getY(), dstPoints[i].getX(), dstPoints[i].getY());
+        maxVal = std::max(maxVal, std::max(srcPoints[i].getX(), srcPoints[i].getY()));
     }
-    cv::minMaxIdx(points_view1, &minVal, &maxVal);
-    F = cv::findFundamentalMat(points_view1, points_view2, cv::FM_RANSAC, m_outlierDistanceRatio * maxVal, m_confidenceLevel, status);
-    if(!F.data){
+
+    Eigen::Matrix3d F;
+    std::vector<uint8_t> status;
+    SolAREpipolarRANSAC ransac(SolAREpipolarRANSAC::Model::FUNDAMENTAL, m_outlierDistanceRatio * maxVal, m_confidenceLevel);
+    if (!ransac.estimate(correspondences, F, status)){
         LOG_DEBUG("Fundamental matrix is empty")
         return api::solver::pose::Transform2DFinder::TRANSFORM2D_EMPTY;
 	}
 
-    F.convertTo(F,CV_32F);
-
-    SolAROpenCVHelper::convertCVMatToSolar(F,fundamental);
+    fundamental.matrix() = F.cast<float>();
     return api::solver::pose::Transform2DFinder::TRANSFORM2D_ESTIMATION_OK;
 }
 
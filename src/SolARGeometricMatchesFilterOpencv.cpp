@@ -15,6 +15,7 @@
  */
 
 #include "SolARGeometricMatchesFilterOpencv.h"
+#include "SolAREpipolarRANSAC.h"
 #include "core/Log.h"
 
 namespace xpcf  = org::bcom::xpcf;
@@ -26,6 +27,28 @@ using namespace datastructure;
 namespace MODULES {
 namespace OPENCV {
 
+// below this number of matches, the epipolar check is not worth being dispatched on several threads
+static const int PARALLEL_MIN_NB_MATCHES = 5000;
+
+// Flag the matches [begin, end) whose point 2 lies at less than maxDistance from the epipolar line l = F12^T * x1 of point 1.
+// The distance |l.x2| / sqrt(a*a + b*b) is compared squared, without division nor square root, so that the loop vectorizes.
+static void epipolarInliers(const Eigen::Matrix3f& F12, const float* x1, const float* y1, const float* x2, const float* y2,
+							float maxDistance, int begin, int end, uchar* inliers)
+{
+	const float f00 = F12(0, 0), f01 = F12(0, 1), f02 = F12(0, 2);
+	const float f10 = F12(1, 0), f11 = F12(1, 1), f12 = F12(1, 2);
+	const float f20 = F12(2, 0), f21 = F12(2, 1), f22 = F12(2, 2);
+	const float maxDistance2 = maxDistance * maxDistance;
+	for (int i = begin; i < end; ++i) {
+		// Epipolar line in second image l = x1'F12 = [a b c]
+		float a = x1[i] * f00 + y1[i] * f10 + f20;
+		float b = x1[i] * f01 + y1[i] * f11 + f21;
+		float c = x1[i] * f02 + y1[i] * f12 + f22;
+		float num = a * x2[i] + b * y2[i] + c;
+		inliers[i] = (num * num < maxDistance2 * (a * a + b * b)) ? 1 : 0;
+	}
+}
+
 SolARGeometricMatchesFilterOpencv::SolARGeometricMatchesFilterOpencv():ConfigurableBase(xpcf::toUUID<SolARGeometricMatchesFilterOpencv>())
 { 
     LOG_DEBUG("SolARGeometricMatchesFilterOpencv constructor")
@@ -49,31 +72,35 @@ void SolARGeometricMatchesFilterOpencv::filter(const std::vector<DescriptorMatch
 {
 
     std::vector<DescriptorMatch>tempMatches;
-    std::vector<uchar> status(inputKeyPointsA.size());
-    std::vector<cv::Point2f> pts1, pts2;
+    std::vector<uint8_t> status;
+    EpipolarCorrespondences correspondences;
 
     if(inputMatches.size()){
 
         // get Align matches
+        correspondences.reserve(inputMatches.size());
+        float maxVal = 0.f;
         for (unsigned int i = 0; i<inputMatches.size(); i++) {
             assert(inputMatches[i].getIndexInDescriptorA() < inputKeyPointsA.size());
-            pts1.push_back(cv::Point2f(inputKeyPointsA[inputMatches[i].getIndexInDescriptorA()].getX(),
-                                       inputKeyPointsA[inputMatches[i].getIndexInDescriptorA()].getY()));
+            const Keypoint &kpA = inputKeyPointsA[inputMatches[i].getIndexInDescriptorA()];
 
             assert(inputMatches[i].getIndexInDescriptorB() < inputKeyPointsB.size());
-            pts2.push_back(cv::Point2f(inputKeyPointsB[inputMatches[i].getIndexInDescriptorB()].getX(),
-                                       inputKeyPointsB[inputMatches[i].getIndexInDescriptorB()].getY()));
+            const Keypoint &kpB = inputKeyPointsB[inputMatches[i].getIndexInDescriptorB()];
 
+            correspondences.push_back(kpA.getX(), kpA.getY(), kpB.getX(), kpB.getY());
+            maxVal = std::max(maxVal, std::max(kpA.getX(), kpA.getY()));
         }
 
-
-        cv::Mat F;
-        {
-            double minVal, maxVal;
-            cv::minMaxIdx(pts1, &minVal, &maxVal);
-            F = cv::findFundamentalMat(pts1, pts2, cv::FM_RANSAC, m_outlierDistanceRatio * maxVal, m_confidence, status);
+        Eigen::Matrix3d F;
+        SolAREpipolarRANSAC ransac(SolAREpipolarRANSAC::Model::FUNDAMENTAL, m_outlierDistanceRatio * maxVal, m_confidence);
+        if (!ransac.estimate(correspondences, F, status)) {
+            // the filter has no return code, no match is kept rather than unchecked ones
+            LOG_WARNING("The fundamental matrix cannot be estimated from {} matches, all of them are filtered out", inputMatches.size());
+            outputMatches.clear();
+            return;
         }
 
+        tempMatches.reserve(status.size());
         for (unsigned int i = 0; i<status.size(); i++) {
             if (status[i]) {
                    tempMatches.push_back(inputMatches[i]);
@@ -86,34 +113,45 @@ void SolARGeometricMatchesFilterOpencv::filter(const std::vector<DescriptorMatch
 
 void SolARGeometricMatchesFilterOpencv::filter(const std::vector<DescriptorMatch>& inputMatches, std::vector<DescriptorMatch>& outputMatches, const std::vector<Keypoint>& inputKeyPoints1, const std::vector<Keypoint>& inputKeyPoints2, const Transform3Df & pose1, const Transform3Df & pose2, const CamCalibration & intrinsicParams)
 {
-	std::vector<DescriptorMatch> tmpMatches;
-	// compute fundamental matrice
+	// compute fundamental matrice F12 = K^-T [T12]x R12 K^-1 with fixed size matrices
 	Transform3Df pose12 = pose1.inverse() * pose2;
-	cv::Mat R12 = (cv::Mat_<float>(3, 3) << pose12(0, 0), pose12(0, 1), pose12(0, 2),
-											pose12(1, 0), pose12(1, 1), pose12(1, 2), 
-											pose12(2, 0), pose12(2, 1), pose12(2, 2));
-	cv::Mat T12 = (cv::Mat_<float>(3, 1) << pose12(0, 3), pose12(1, 3), pose12(2, 3));
-
-	cv::Mat T12x = (cv::Mat_<float>(3, 3) << 0, -T12.at<float>(2), T12.at<float>(1),
-											T12.at<float>(2), 0, -T12.at<float>(0),
-											-T12.at<float>(1), T12.at<float>(0), 0);
-
-	cv::Mat K(3, 3, CV_32FC1, (void *)intrinsicParams.data());		
-	cv::Mat F12 = K.t().inv() * T12x * R12 * K.inv();
-	
+	Eigen::Matrix3f R12 = pose12.linear();
+	Eigen::Vector3f T12 = pose12.translation();
+	Eigen::Matrix3f T12x;
+	T12x << 0, -T12(2), T12(1),
+			T12(2), 0, -T12(0),
+			-T12(1), T12(0), 0;
+	Eigen::Matrix3f K = intrinsicParams;
+	Eigen::Matrix3f Kinv = K.inverse();
+	Eigen::Matrix3f F12 = Kinv.transpose() * T12x * R12 * Kinv;
+
+	// gather matched keypoint coordinates
+	const int nbMatches = static_cast<int>(inputMatches.size());
+	std::vector<float> x1(nbMatches), y1(nbMatches), x2(nbMatches), y2(nbMatches);
+	for (int i = 0; i < nbMatches; ++i) {
+		const Keypoint &kp1 = inputKeyPoints1[inputMatches[i].getIndexInDescriptorA()];
+		const Keypoint &kp2 = inputKeyPoints2[inputMatches[i].getIndexInDescriptorB()];
+		x1[i] = kp1.getX();
+		y1[i] = kp1.getY();
+		x2[i] = kp2.getX();
+		y2[i] = kp2.getY();
+	}
+
 	// check matches based on distance to epipolar lines
-	for (int i = 0; i < inputMatches.size(); ++i) {		
-		Keypoint kp1 = inputKeyPoints1[inputMatches[i].getIndexInDescriptorA()];
-		Keypoint kp2 = inputKeyPoints2[inputMatches[i].getIndexInDescriptorB()];
-		// Epipolar line in second image l = x1'F12 = [a b c]
-		double a = kp1.getX() * F12.at<float>(0, 0) + kp1.getY() * F12.at<float>(1, 0) + F12.at<float>(2, 0);
-		double b = kp1.getX() * F12.at<float>(0, 1) + kp1.getY() * F12.at<float>(1, 1) + F12.at<float>(2, 1);
-		double c = kp1.getX() * F12.at<float>(0, 2) + kp1.getY() * F12.at<float>(1, 2) + F12.at<float>(2, 2);
-		double dis = std::fabs(a * kp2.getX() + b * kp2.getY() + c) / (std::sqrt(a * a + b * b));
+	std::vector<uchar> inliers(nbMatches);
+	auto checkEpipolarDistances = [&](const cv::Range& range) {
+		epipolarInliers(F12, x1.data(), y1.data(), x2.data(), y2.data(), m_epilinesDistance, range.start, range.end, inliers.data());
+	};
+	if (nbMatches > PARALLEL_MIN_NB_MATCHES)
+		cv::parallel_for_(cv::Range(0, nbMatches), checkEpipolarDistances);
+	else
+		checkEpipolarDistances(cv::Range(0, nbMatches));
 
-		if (dis < m_epilinesDistance)
+	std::vector<DescriptorMatch> tmpMatches;
+	tmpMatches.reserve(nbMatches);
+	for (int i = 0; i < nbMatches; ++i)
+		if (inliers[i])
 			tmpMatches.push_back(inputMatches[i]);
-	}
 	outputMatches.swap(tmpMatches);
 }
 
@@ -18,6 +18,11 @@
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
+#include "opencv2/core/hal/intrin.hpp"
+
+#include <algorithm>
+#include <limits>
+
 namespace xpcf  = org::bcom::xpcf;
 
 XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARImageFilterAdaptiveBinaryOpencv)
@@ -27,12 +32,113 @@ using namespace datastructure;
 namespace MODULES {
 namespace OPENCV {
 
+namespace {
+
+// Thresholds the rows [y0, y1) of src against the mean of the blockSize x blockSize neighborhood of each pixel, the border being replicated.
+// colSums holds the sums of the blockSize rows around the current row for each column, padded by the radius on both sides,
+// and is slid down from one row to the next. A pixel is set if src + C > round(sum / area), which is tested exactly in integers
+// as 2 * sum < area * (2 * (src + C) - 1) since the area is odd and the mean is never halfway between two integers.
+void thresholdRows(const cv::Mat & src, cv::Mat & dst, int y0, int y1, int blockSize, uchar maxValue, int C)
+{
+    const int width = src.cols;
+    const int height = src.rows;
+    const int radius = blockSize / 2;
+    const int area = blockSize * blockSize;
+    const int offset = area * (2 * C - 1);
+    std::vector<int> colSums(width + 2 * radius, 0);
+    std::vector<int> prefix(width + 2 * radius + 1, 0);
+    int * sums = colSums.data() + radius;
+
+    for (int dy = -radius; dy <= radius; dy++)
+    {
+        const uchar * row = src.ptr<uchar>(std::min(std::max(y0 + dy, 0), height - 1));
+        for (int x = 0; x < width; x++)
+            sums[x] += row[x];
+    }
+
+    for (int y = y0; y < y1; y++)
+    {
+        // replicate the columns of the border
+        for (int k = 1; k <= radius; k++)
+        {
+            sums[-k] = sums[0];
+            sums[width - 1 + k] = sums[width - 1];
+        }
+        for (size_t k = 0; k < colSums.size(); k++)
+            prefix[k + 1] = prefix[k] + colSums[k];
+
+        const uchar * srcRow = src.ptr<uchar>(y);
+        uchar * dstRow = dst.ptr<uchar>(y);
+        const int * windowEnd = prefix.data() + blockSize;
+        const int * windowStart = prefix.data();
+        int x = 0;
+#if CV_SIMD
+        const int nlanes = cv::v_uint8::nlanes;
+        const int nlanes32 = cv::v_int32::nlanes;
+        const cv::v_int32 vArea2 = cv::vx_setall_s32(2 * area);
+        const cv::v_int32 vOffset = cv::vx_setall_s32(offset);
+        const cv::v_uint8 vMax = cv::vx_setall_u8(maxValue);
+        for (; x <= width - nlanes; x += nlanes)
+        {
+            cv::v_uint16 s0, s1;
+            cv::v_expand(cv::vx_load(srcRow + x), s0, s1);
+            cv::v_uint32 p[4];
+            cv::v_expand(s0, p[0], p[1]);
+            cv::v_expand(s1, p[2], p[3]);
+            cv::v_int32 mask[4];
+            for (int k = 0; k < 4; k++)
+            {
+                int xk = x + k * nlanes32;
+                cv::v_int32 sum = cv::vx_load(windowEnd + xk) - cv::vx_load(windowStart + xk);
+                mask[k] = (sum + sum) < (vArea2 * cv::v_reinterpret_as_s32(p[k]) + vOffset);
+            }
+            cv::v_int8 packed = cv::v_pack(cv::v_pack(mask[0], mask[1]), cv::v_pack(mask[2], mask[3]));
+            cv::v_store(dstRow + x, cv::v_reinterpret_as_u8(packed) & vMax);
+        }
+#endif
+        for (; x < width; x++)
+        {
+            int sum = windowEnd[x] - windowStart[x];
+            dstRow[x] = 2 * sum < 2 * area * srcRow[x] + offset ? maxValue : 0;
+        }
+
+        // slide the column sums to the next row
+        if (y + 1 < y1)
+        {
+            const uchar * addRow = src.ptr<uchar>(std::min(y + radius + 1, height - 1));
+            const uchar * subRow = src.ptr<uchar>(std::max(y - radius, 0));
+            x = 0;
+#if CV_SIMD
+            for (; x <= width - nlanes; x += nlanes)
+            {
+                cv::v_uint16 a0, a1, b0, b1;
+                cv::v_expand(cv::vx_load(addRow + x), a0, a1);
+                cv::v_expand(cv::vx_load(subRow + x), b0, b1);
+                cv::v_int32 d[4];
+                cv::v_expand(cv::v_reinterpret_as_s16(a0) - cv::v_reinterpret_as_s16(b0), d[0], d[1]);
+                cv::v_expand(cv::v_reinterpret_as_s16(a1) - cv::v_reinterpret_as_s16(b1), d[2], d[3]);
+                for (int k = 0; k < 4; k++)
+                    cv::v_store(sums + x + k * nlanes32, cv::vx_load(sums + x + k * nlanes32) + d[k]);
+            }
+#endif
+            for (; x < width; x++)
+                sums[x] += addRow[x] - subRow[x];
+        }
+    }
+#if CV_SIMD
+    cv::vx_cleanup();
+#endif
+}
+
+}
+
 SolARImageFilterAdaptiveBinaryOpencv::SolARImageFilterAdaptiveBinaryOpencv():ConfigurableBase(xpcf::toUUID<SolARImageFilterAdaptiveBinaryOpencv>())
 {
     declareInterface<api::image::IImageFilter>(this);
     declareProperty("max", m_max);
     declareProperty("blockSize", m_blockSize);
     declareProperty("C", m_C);
+    declareProperty("meanScale", m_meanScale);
 
 }
 
@@ -43,26 +149,82 @@ SolARImageFilterAdaptiveBinaryOpencv::~SolARImageFilterAdaptiveBinaryOpencv(){
 
 
 FrameworkReturnCode SolARImageFilterAdaptiveBinaryOpencv::filter(const SRef<Image>input, SRef<Image>& output){
-    if (input->getImageLayout() != Image::ImageLayout::LAYOUT_GREY)
+    if (input->getImageLayout() != Image::ImageLayout::LAYOUT_GREY || input->getDataType() != Image::DataType::TYPE_8U)
     {
         LOG_ERROR ("binarize method take as input only Grey images");
         return FrameworkReturnCode::_ERROR_;
     }
+    if (m_blockSize < 3 || m_blockSize % 2 == 0)
+    {
+        LOG_ERROR ("The block size of the adaptive threshold must be odd and greater than 1");
+        return FrameworkReturnCode::_ERROR_;
+    }
 
-    if (!output)
-        output = xpcf::utils::make_shared<Image> (Image::ImageLayout::LAYOUT_GREY, input->getPixelOrder(), input->getDataType());
-
-    output->setSize(input->getWidth(),input->getHeight());
+    // The output image is reused from one frame to the next, it is only resized when the input size changes
+    SolAROpenCVHelper::prepareImage(input->getWidth(), input->getHeight(), Image::ImageLayout::LAYOUT_GREY, input->getPixelOrder(), input->getDataType(), output);
 
     cv::Mat imgSource, imgFiltred;
     SolAROpenCVHelper::mapToOpenCV(input,imgSource);
     SolAROpenCVHelper::mapToOpenCV(output,imgFiltred);
+    // The neighborhood of a pixel is read after the rows above it are written
+    if (imgSource.data == imgFiltred.data)
+    {
+        imgSource.copyTo(m_source);
+        imgSource = m_source;
+    }
 
-    cv::adaptiveThreshold(imgSource, imgFiltred, m_max, cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY, m_blockSize, m_C);
+    if (m_meanScale > 1)
+        adaptiveThresholdDownscaled(imgSource, imgFiltred, m_max, m_blockSize, m_C, m_meanScale);
+    else
+        adaptiveThreshold(imgSource, imgFiltred, m_max, m_blockSize, m_C);
 
     return FrameworkReturnCode::_SUCCESS;
 }
 
+void SolARImageFilterAdaptiveBinaryOpencv::adaptiveThreshold(const cv::Mat & src, cv::Mat & dst, int maxValue, int blockSize, int C)
+{
+    // Fall back on OpenCV when the sums of the neighborhood would overflow
+    int64_t area = static_cast<int64_t>(blockSize) * blockSize;
+    if (area * (2 * 255 + 2 * std::abs(static_cast<int64_t>(C)) + 1) > std::numeric_limits<int>::max()
+            || static_cast<int64_t>(src.cols + blockSize) * blockSize * 255 > std::numeric_limits<int>::max())
+    {
+        cv::adaptiveThreshold(src, dst, maxValue, cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY, blockSize, C);
+        return;
+    }
+    dst.create(src.size(), CV_8UC1);
+    if (maxValue < 0)
+    {
+        dst.setTo(0);
+        return;
+    }
+    uchar imaxval = cv::saturate_cast<uchar>(maxValue);
+    // Each band of rows initializes its own column sums, bands are kept a few blocks high to amortize it
+    int nbStripes = std::max(1, src.rows / (4 * blockSize));
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range & range) {
+        thresholdRows(src, dst, range.start, range.end, blockSize, imaxval, C);
+    }, nbStripes);
+}
+
+void SolARImageFilterAdaptiveBinaryOpencv::adaptiveThresholdDownscaled(const cv::Mat & src, cv::Mat & dst, int maxValue, int blockSize, int C, int scale)
+{
+    // The mean is computed on the image downscaled by scale and read at the nearest downscaled pixel
+    cv::Size smallSize((src.cols + scale - 1) / scale, (src.rows + scale - 1) / scale);
+    cv::resize(src, m_small, smallSize, 0, 0, cv::INTER_AREA);
+    int smallBlockSize = std::max(3, (blockSize / scale) | 1);
+    cv::blur(m_small, m_smallMean, cv::Size(smallBlockSize, smallBlockSize), cv::Point(-1, -1), cv::BORDER_REPLICATE);
+    dst.create(src.size(), CV_8UC1);
+    uchar imaxval = maxValue < 0 ? 0 : cv::saturate_cast<uchar>(maxValue);
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range & range) {
+        for (int y = range.start; y < range.end; y++)
+        {
+            const uchar * srcRow = src.ptr<uchar>(y);
+            const uchar * meanRow = m_smallMean.ptr<uchar>(y / scale);
+            uchar * dstRow = dst.ptr<uchar>(y);
+            for (int x = 0; x < src.cols; x++)
+                dstRow[x] = srcRow[x] + C > meanRow[x / scale] ? imaxval : 0;
+        }
+    });
+}
 
 }
 }
@@ -51,10 +51,8 @@ FrameworkReturnCode SolARImageFilterBinaryOpencv::filter(const SRef<Image>input,
         return FrameworkReturnCode::_ERROR_;
     }
 
-    if (!output)
-        output = xpcf::utils::make_shared<Image> (Image::ImageLayout::LAYOUT_GREY, input->getPixelOrder(), input->getDataType());
-
-    output->setSize(input->getWidth(),input->getHeight());
+    // output can be input, the threshold is applied pixel per pixel
+    SolAROpenCVHelper::prepareImage(input->getWidth(), input->getHeight(), Image::ImageLayout::LAYOUT_GREY, input->getPixelOrder(), input->getDataType(), output);
 
     cv::Mat imgSource, imgFiltred;
     SolAROpenCVHelper::mapToOpenCV(input,imgSource);
@@ -16,6 +16,7 @@
 
 #include "SolARImageFilterBlurOpencv.h"
 #include "SolAROpenCVHelper.h"
+#include "SolARFastGaussian.h"
 #include "core/Log.h"
 
 namespace xpcf  = org::bcom::xpcf;
@@ -44,13 +45,16 @@ SolARImageFilterBlurOpencv::~SolARImageFilterBlurOpencv(){
 
 FrameworkReturnCode SolARImageFilterBlurOpencv::filter(const SRef<Image>input, SRef<Image>& output){
 
-    if (!output)
-        output = xpcf::utils::make_shared<Image> (input->getImageLayout(), input->getPixelOrder(), input->getDataType());
-
-    output->setSize(input->getWidth(),input->getHeight());
+    SolAROpenCVHelper::prepareImage(input->getWidth(), input->getHeight(), input->getImageLayout(), input->getPixelOrder(), input->getDataType(), output);
     cv::Mat imgSource, imgFiltred;
     SolAROpenCVHelper::mapToOpenCV(input,imgSource);
     SolAROpenCVHelper::mapToOpenCV(output,imgFiltred);
+    // In place, the neighborhoods are read from a copy of the source
+    if (imgSource.data == imgFiltred.data)
+    {
+        imgSource.copyTo(m_source);
+        imgSource = m_source;
+    }
 
     switch (direction) {
     case 0:{
@@ -72,6 +76,14 @@ FrameworkReturnCode SolARImageFilterBlurOpencv::filter(const SRef<Image>input, S
         LOG_DEBUG("    <Bilateral blurring>:")
         cv::bilateralFilter(imgSource, imgFiltred,kernel_width, kernel_width*2, kernel_height/2);
         break;
+   }
+    case 4:{
+        LOG_DEBUG("    <Fast Gaussian blurring>:")
+        // same standard deviations as the Gaussian blurring for this kernel size, which is applied when they are too small for the boxes
+        float sigmaX = 0.3f * ((kernel_width - 1) * 0.5f - 1.f) + 0.8f;
+        float sigmaY = kernel_height > 0 ? 0.3f * ((kernel_height - 1) * 0.5f - 1.f) + 0.8f : 0.f;
+        SolARFastGaussian::blur(imgSource, imgFiltred, cv::Size(kernel_width, kernel_height), sigmaX, sigmaY);
+        break;
    }
     default:
         break;
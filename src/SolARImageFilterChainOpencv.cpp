@@ -0,0 +1,132 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SolARImageFilterChainOpencv.h"
+#include "SolAROpenCVHelper.h"
+#include "core/Log.h"
+
+#include "opencv2/imgproc.hpp"
+
+#include <algorithm>
+
+namespace xpcf  = org::bcom::xpcf;
+
+XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARImageFilterChainOpencv)
+
+namespace SolAR {
+using namespace datastructure;
+namespace MODULES {
+namespace OPENCV {
+
+namespace {
+
+cv::Mat morphologyElement(int elem, int size)
+{
+    int type = cv::MORPH_RECT;
+    if (elem == 1) type = cv::MORPH_CROSS;
+    else if (elem == 2) type = cv::MORPH_ELLIPSE;
+    return cv::getStructuringElement(type, cv::Size(2 * size + 1, 2 * size + 1), cv::Point(size, size));
+}
+
+}
+
+SolARImageFilterChainOpencv::SolARImageFilterChainOpencv():ConfigurableBase(xpcf::toUUID<SolARImageFilterChainOpencv>())
+{
+    declareInterface<api::image::IImageFilter>(this);
+    declareProperty("kernel_width", m_kernelWidth);
+    declareProperty("kernel_height", m_kernelHeight);
+    declareProperty("min", m_min);
+    declareProperty("max", m_max);
+    declareProperty("erosion_elem", m_erosionElem);
+    declareProperty("erosion_size", m_erosionSize);
+    declareProperty("dilate_elem", m_dilateElem);
+    declareProperty("dilate_size", m_dilateSize);
+    declareProperty("tileHeight", m_tileHeight);
+}
+
+FrameworkReturnCode SolARImageFilterChainOpencv::filter(const SRef<Image>input, SRef<Image>& output)
+{
+    if (input->getImageLayout() != Image::ImageLayout::LAYOUT_GREY)
+    {
+        LOG_ERROR ("SolARImageFilterChainOpencv takes as input only Grey images");
+        return FrameworkReturnCode::_ERROR_;
+    }
+    if (m_min < 0)
+    {
+        LOG_ERROR ("SolARImageFilterChainOpencv does not support the Otsu threshold, min must be positive");
+        return FrameworkReturnCode::_ERROR_;
+    }
+
+    SolAROpenCVHelper::prepareImage(input->getWidth(), input->getHeight(), Image::ImageLayout::LAYOUT_GREY, input->getPixelOrder(), input->getDataType(), output);
+    cv::Mat imgSource, imgFiltred;
+    SolAROpenCVHelper::mapToOpenCV(input,imgSource);
+    SolAROpenCVHelper::mapToOpenCV(output,imgFiltred);
+    // In place, the neighborhoods of a band are read from a copy of the source
+    if (imgSource.data == imgFiltred.data)
+    {
+        imgSource.copyTo(m_source);
+        imgSource = m_source;
+    }
+
+    bool blur = m_kernelWidth > 0 && m_kernelHeight > 0;
+    cv::Mat erosionElement, dilateElement;
+    if (m_erosionSize > 0)
+        erosionElement = morphologyElement(m_erosionElem, m_erosionSize);
+    if (m_dilateSize > 0)
+        dilateElement = morphologyElement(m_dilateElem, m_dilateSize);
+    // The rows of the binary image around a band that the morphological operations need
+    int margin = std::max(m_erosionSize, 0) + std::max(m_dilateSize, 0);
+    int tileHeight = std::max(m_tileHeight, 1);
+    int nbTiles = (imgSource.rows + tileHeight - 1) / tileHeight;
+
+    cv::parallel_for_(cv::Range(0, nbTiles), [&](const cv::Range & range) {
+        cv::Mat blurred, binary, eroded, dilated;
+        for (int tile = range.start; tile < range.end; tile++)
+        {
+            int y0 = tile * tileHeight;
+            int y1 = std::min(y0 + tileHeight, imgSource.rows);
+            int a = std::max(y0 - margin, 0);
+            int b = std::min(y1 + margin, imgSource.rows);
+            // The blur of a band of the source reads the rows around it from the whole image, so the band is blurred as in the whole image
+            cv::Mat band = imgSource.rowRange(a, b);
+            if (blur)
+            {
+                cv::blur(band, blurred, cv::Size(m_kernelWidth, m_kernelHeight), cv::Point(-1,-1));
+                band = blurred;
+            }
+            cv::threshold(band, binary, m_min, m_max, cv::THRESH_BINARY);
+            // The rows of the margin are wrong after a morphological operation, except at the border of the image, but are not used
+            cv::Mat result = binary;
+            if (!erosionElement.empty())
+            {
+                cv::erode(result, eroded, erosionElement);
+                result = eroded;
+            }
+            if (!dilateElement.empty())
+            {
+                cv::dilate(result, dilated, dilateElement);
+                result = dilated;
+            }
+            result.rowRange(y0 - a, y1 - a).copyTo(imgFiltred.rowRange(y0, y1));
+        }
+    });
+
+    return FrameworkReturnCode::_SUCCESS;
+}
+
+}
+}
+}
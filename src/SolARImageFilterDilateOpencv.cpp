@@ -42,14 +42,17 @@ SolARImageFilterDilateOpencv::~SolARImageFilterDilateOpencv(){
 FrameworkReturnCode SolARImageFilterDilateOpencv::filter(const SRef<Image>input,
               SRef<Image>& output){
 
-    if (!output)
-        output = xpcf::utils::make_shared<Image> (input->getImageLayout(), input->getPixelOrder(), input->getDataType());
-
-    output->setSize(input->getWidth(),input->getHeight());
+    SolAROpenCVHelper::prepareImage(input->getWidth(), input->getHeight(), input->getImageLayout(), input->getPixelOrder(), input->getDataType(), output);
 
     cv::Mat imgSource, imgFiltred;
     SolAROpenCVHelper::mapToOpenCV(input,imgSource);
     SolAROpenCVHelper::mapToOpenCV(output,imgFiltred);
+    // In place, the neighborhoods are read from a copy of the source
+    if (imgSource.data == imgFiltred.data)
+    {
+        imgSource.copyTo(m_source);
+        imgSource = m_source;
+    }
 
     int dilate_type;
     if(dilate_elem == 0 ){ dilate_type = cv::MORPH_RECT; }
@@ -15,6 +15,8 @@
  */
 
 #include "SolARImageViewerOpencv.h"
+#include "SolARVideoRecorderOpencv.h"
+#include "xpcf/component/ComponentFactory.h"
 #include <opencv2/highgui.hpp>
 #include "core/Log.h"
 
@@ -38,6 +40,17 @@ static std::map<std::tuple<uint32_t,std::size_t,uint32_t>,int> solar2cvTypeConve
     {std::make_tuple(8,1,1),CV_8UC1},
     {std::make_tuple(16,1,1), CV_16UC1}};
 
+static const int BACKEND_WINDOW = 0;
+static const int BACKEND_RECORD = 1;
+static const int BACKEND_NULL = 2;
+
+static std::map<std::string, int> convertBackend = {{"WINDOW", BACKEND_WINDOW},
+                                                    {"RECORD", BACKEND_RECORD},
+                                                    {"NULL", BACKEND_NULL}};
+
+// period in milliseconds at which the display thread processes the window events
+static const int EVENTS_PERIOD = 10;
+
 inline int deduceOpenCVType(SRef<Image> img)
 {
     // TODO : handle safe mode if missing map entry
@@ -55,12 +68,19 @@ SolARImageViewerOpencv::SolARImageViewerOpencv():ConfigurableBase(xpcf::toUUID<S
     declareProperty("height", m_height);
     declareProperty("exitKey", m_exitKey);
     declareProperty("duration", m_duration);
+    declareProperty("asynchronous", m_asynchronous);
+    declareProperty("backend", m_backend);
+    declareProperty("recordFile", m_recordFile);
+    declareProperty("recordFrameRate", m_recordFrameRate);
     LOG_DEBUG(" SolARImageViewerOpencv constructor")
 }
 
 
 SolARImageViewerOpencv::~SolARImageViewerOpencv()
 {
+    stopDisplayThread();
+    if (m_recorder)
+        m_recorder->close();
     LOG_DEBUG(" SolARImageViewerOpencv destructor")
 }
 
@@ -90,29 +110,133 @@ FrameworkReturnCode SolARImageViewerOpencv::display(const SRef<Image> img)
 FrameworkReturnCode SolARImageViewerOpencv::displayKey(const SRef<Image> img, char& key)
 {
     key=0;
+    if (m_backendId < 0)
+    {
+        auto itr = convertBackend.find(m_backend);
+        if (itr == convertBackend.end())
+        {
+            LOG_WARNING("Image viewer backend {} does not exist, WINDOW is used", m_backend);
+            m_backendId = BACKEND_WINDOW;
+        }
+        else
+            m_backendId = itr->second;
+        if (m_backendId == BACKEND_RECORD && m_recordFile.empty())
+        {
+            LOG_ERROR("Image viewer {} has no recordFile to record into, the images are dropped", m_title);
+            m_backendId = BACKEND_NULL;
+        }
+#ifdef __APPLE__
+        // HighGUI only supports windows handled by the main thread with Cocoa
+        if (m_backendId == BACKEND_WINDOW && m_asynchronous)
+        {
+            LOG_WARNING("Image viewer {} cannot display asynchronously on macOS, the images are displayed synchronously", m_title);
+            m_asynchronous = 0;
+        }
+#endif
+    }
+    if (m_backendId == BACKEND_NULL)
+        return FrameworkReturnCode::_SUCCESS;
+
+    if (m_backendId == BACKEND_RECORD)
+    {
+        // the images are encoded in the background by a video recorder, which keeps the latest one when the encoder is late
+        if (!m_recorder)
+        {
+            SRef<IImageRecorder> recorder = xpcf::ComponentFactory::createInstance<SolARVideoRecorderOpencv>()->bindTo<IImageRecorder>();
+            SRef<xpcf::IConfigurable> configurable = recorder->bindTo<xpcf::IConfigurable>();
+            configurable->getProperty("outputPath")->setStringValue(m_recordFile.c_str());
+            configurable->getProperty("format")->setStringValue("VIDEO");
+            configurable->getProperty("codec")->setStringValue("MJPG");
+            configurable->getProperty("frameRate")->setFloatingValue(m_recordFrameRate);
+            configurable->getProperty("queueSize")->setIntegerValue(1);
+            configurable->getProperty("dropPolicy")->setStringValue("DROP_OLDEST");
+            m_recorder = recorder;
+            m_recordStart = std::chrono::steady_clock::now();
+        }
+        double timestamp = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_recordStart).count();
+        return m_recorder->record(img, timestamp);
+    }
+
     cv::Mat imgSource(img->getHeight(),img->getWidth(),deduceOpenCVType(img), img->data());
+    if (m_backendId == BACKEND_WINDOW && !m_asynchronous)
+    {
+        if (m_duration >0)
+            key = show(imgSource, m_duration);  // wait for a keystroke to display window
+        else if (m_exitKey >= 0)
+            key = show(imgSource, 10);  // wait for a keystroke to display window
+        else
+            key = show(imgSource, 1);  // wait for a keystroke to display window
+    }
+    else
+    {
+        // the image is copied outside of the lock, then replaces the one of the mailbox
+        imgSource.copyTo(m_backFrame);
+        {
+            std::lock_guard<std::mutex> lock(m_mailboxMutex);
+            cv::swap(m_backFrame, m_mailboxFrame);
+            m_hasNewFrame = true;
+        }
+        if (!m_displayThread.joinable())
+            m_displayThread = std::thread(&SolARImageViewerOpencv::displayLoop, this);
+        key = m_lastKey.exchange(0);
+    }
+
+    if(key == (char)(m_exitKey))
+        return FrameworkReturnCode::_STOP;
+
+    return FrameworkReturnCode::_SUCCESS;
+}
+
+char SolARImageViewerOpencv::show(const cv::Mat & image, int delay)
+{
     cv::namedWindow( m_title,0); // Create a window for display.
     if (m_isFirstDisplay)
     {
         if(m_width>0 && m_height>0)
             cv::resizeWindow(m_title, m_width,m_height);
         else
-            cv::resizeWindow(m_title, img->getWidth(), img->getHeight());
+            cv::resizeWindow(m_title, image.cols, image.rows);
         m_isFirstDisplay = false;
     }
 
-    cv::imshow(m_title, imgSource);
-    if (m_duration >0)
-        key = cv::waitKey(m_duration);  // wait for a keystroke to display window
-    else if (m_exitKey >= 0)
-        key = cv::waitKey(10);  // wait for a keystroke to display window
-    else
-        key = cv::waitKey(1);  // wait for a keystroke to display window
+    cv::imshow(m_title, image);
+    return (char)cv::waitKey(delay);
+}
 
-    if(key == (char)(m_exitKey))
-        return FrameworkReturnCode::_STOP;
+void SolARImageViewerOpencv::displayLoop()
+{
+    cv::Mat frame;
+    for (;;)
+    {
+        bool hasFrame = false;
+        {
+            // the window events are processed even when no new image comes
+            std::lock_guard<std::mutex> lock(m_mailboxMutex);
+            if (m_hasNewFrame)
+            {
+                cv::swap(frame, m_mailboxFrame);
+                m_hasNewFrame = false;
+                hasFrame = true;
+            }
+            else if (m_stopDisplay)
+                break;
+        }
+
+        char key = hasFrame ? show(frame, EVENTS_PERIOD) : (char)cv::waitKey(EVENTS_PERIOD);
+        if (key != (char)-1)
+            m_lastKey = key;
+    }
+}
 
-    return FrameworkReturnCode::_SUCCESS;
+void SolARImageViewerOpencv::stopDisplayThread()
+{
+    if (!m_displayThread.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mailboxMutex);
+        m_stopDisplay = true;
+    }
+    m_displayThread.join();
 }
 
 }
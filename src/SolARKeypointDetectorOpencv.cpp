@@ -15,6 +15,7 @@
  */
 
 #include "SolARKeypointDetectorOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
@@ -55,6 +56,7 @@ SolARKeypointDetectorOpencv::SolARKeypointDetectorOpencv():ConfigurableBase(xpcf
     declareProperty("threshold", m_threshold);
     declareProperty("nbOctaves", m_nbOctaves);
     declareProperty("type", m_type);
+    declareProperty("profiling", m_profiling);
     LOG_DEBUG("SolARKeypointDetectorOpencv constructor");
 }
 
@@ -147,6 +149,7 @@ IKeypointDetector::KeypointDetectorType SolARKeypointDetectorOpencv::getType()
 
 void SolARKeypointDetectorOpencv::detect(const SRef<Image> image, std::vector<Keypoint> & keypoints)
 {
+    SolARScopedTimer timer("SolARKeypointDetectorOpencv::detect", m_profiling != 0);
     std::vector<cv::KeyPoint> kpts;
 
     // the input image is down-scaled to accelerate the keypoints extraction
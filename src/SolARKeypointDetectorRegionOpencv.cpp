@@ -15,9 +15,12 @@
  */
 
 #include "SolARKeypointDetectorRegionOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
+#include <algorithm>
+
 XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARKeypointDetectorRegionOpencv)
 
 namespace xpcf = org::bcom::xpcf;
@@ -55,6 +58,7 @@ SolARKeypointDetectorRegionOpencv::SolARKeypointDetectorRegionOpencv():Configura
     declareProperty("nbDescriptors", m_nbDescriptors);
     declareProperty("threshold", m_threshold);
     declareProperty("type", m_type);
+    declareProperty("profiling", m_profiling);
     LOG_DEBUG("SolARKeypointDetectorRegionOpencv constructor");
 }
 
@@ -143,9 +147,23 @@ IKeypointDetector::KeypointDetectorType SolARKeypointDetectorRegionOpencv::getTy
     return stringToType.at(m_type);
 }
 
-void goodFeaturesToTrackDetection(cv::Mat &img, int &nbDescriptors, std::vector<cv::KeyPoint> &kpts) {
+namespace {
+
+// the margin in pixels of the detection image kept around the region, so that the detectors see the neighborhood of its keypoints
+const int REGION_MARGIN = 32;
+// the fractional bits of the polygon vertices drawn in the mask
+const int MASK_SHIFT = 4;
+// the values of the mask inside the region and at its border, where the keypoints are tested against the polygon
+const uchar MASK_INSIDE = 255;
+const uchar MASK_BORDER = 128;
+
+}
+
+void goodFeaturesToTrackDetection(cv::Mat &img, int &nbDescriptors, std::vector<cv::KeyPoint> &kpts, const cv::Mat &mask) {
 	std::vector<cv::Point2f> corners;
-	cv::goodFeaturesToTrack(img, corners, nbDescriptors, 0.008, 3, cv::Mat(), 3);
+	cv::goodFeaturesToTrack(img, corners, nbDescriptors, 0.008, 3, mask, 3);
+	if (corners.empty())
+		return;
 	cornerSubPix(img, corners, cv::Size(7, 7), Size(-1, -1), cv::TermCriteria(TermCriteria::COUNT | TermCriteria::EPS, 20, 0.03));
 	for (auto it : corners) {
 		kpts.push_back(cv::KeyPoint(it, 0.f));
@@ -154,6 +172,7 @@ void goodFeaturesToTrackDetection(cv::Mat &img, int &nbDescriptors, std::vector<
 
 void SolARKeypointDetectorRegionOpencv::detect(const SRef<Image> image, const std::vector<Point2Df> & contours, std::vector<Keypoint> & keypoints)
 {
+    SolARScopedTimer timer("SolARKeypointDetectorRegionOpencv::detect", m_profiling != 0);
     std::vector<cv::KeyPoint> kpts;
 
     // the input image is down-scaled to accelerate the keypoints extraction
@@ -161,30 +180,57 @@ void SolARKeypointDetectorRegionOpencv::detect(const SRef<Image> image, const st
     float ratioInv=1.f/m_imageRatio;
 
     keypoints.clear();
+    if (contours.size() < 3)
+        return;
 
     // instantiation of an opencv image from an input IImage
     cv::Mat opencvImage = SolAROpenCVHelper::mapToOpenCV(image);
 
+    // the detection is restricted to the bounding box of the region, expanded by a margin at the detection scale
+    m_polygon.resize(contours.size());
+    for (size_t i = 0; i < contours.size(); ++i)
+        m_polygon[i] = cv::Point2f(contours[i].getX(), contours[i].getY());
+    int margin = cvCeil(REGION_MARGIN * ratioInv);
+    cv::Rect box = cv::boundingRect(m_polygon);
+    cv::Rect roi = cv::Rect(box.x - margin, box.y - margin, box.width + 2 * margin, box.height + 2 * margin) & cv::Rect(0, 0, opencvImage.cols, opencvImage.rows);
+    if (roi.empty())
+        return;
+
 	cv::Mat img_1;
-	if (opencvImage.channels() != 1)
-		cvtColor(opencvImage, img_1, COLOR_BGR2GRAY);
+	if (opencvImage.channels() != 1) {
+		cvtColor(opencvImage(roi), m_grey, COLOR_BGR2GRAY);
+		img_1 = m_grey;
+	}
 	else
-		img_1 = opencvImage;
-    cv::resize(img_1, img_1, Size(img_1.cols*m_imageRatio,img_1.rows*m_imageRatio), 0, 0);
-	
+		img_1 = opencvImage(roi);
+    if (m_imageRatio != 1.f) {
+        cv::resize(img_1, m_resized, Size(roi.width*m_imageRatio,roi.height*m_imageRatio), 0, 0);
+        img_1 = m_resized;
+    }
+
+    // the mask covers the region, its border is marked to test the keypoints close to the edges against the polygon
+    float scale = static_cast<float>(1 << MASK_SHIFT);
+    m_maskPolygon.resize(contours.size());
+    for (size_t i = 0; i < contours.size(); ++i)
+        m_maskPolygon[i] = cv::Point(cvRound((m_polygon[i].x - roi.x) * m_imageRatio * scale), cvRound((m_polygon[i].y - roi.y) * m_imageRatio * scale));
+    m_mask.create(img_1.size(), CV_8UC1);
+    m_mask.setTo(0);
+    const cv::Point * polygon = m_maskPolygon.data();
+    int nbVertices = static_cast<int>(m_maskPolygon.size());
+    cv::fillPoly(m_mask, &polygon, &nbVertices, 1, cv::Scalar(MASK_INSIDE), cv::LINE_8, MASK_SHIFT);
+    cv::polylines(m_mask, &polygon, &nbVertices, 1, true, cv::Scalar(MASK_BORDER), 4, cv::LINE_8, MASK_SHIFT);
+
     try
     {
 		if (m_type == "FEATURE_TO_TRACK") {
-			goodFeaturesToTrackDetection(img_1, m_nbDescriptors, kpts);
+			goodFeaturesToTrackDetection(img_1, m_nbDescriptors, kpts, m_mask);
 		}
 		else {
 			if (!m_detector) {
 				LOG_DEBUG(" detector is initialized with default value : {}", this->m_type)
 					setType(stringToType.at(this->m_type));
 			}
-			m_detector->detect(img_1, kpts, Mat());
-			if (m_nbDescriptors >= 0)
-				kptsFilter.retainBest(kpts, m_nbDescriptors);
+			m_detector->detect(img_1, kpts, m_mask);
 		}
     }
     catch (Exception& e)
@@ -192,44 +238,32 @@ void SolARKeypointDetectorRegionOpencv::detect(const SRef<Image> image, const st
         LOG_ERROR("Feature : {}", m_detector->getDefaultName())
         LOG_ERROR("{}",e.msg)
         return;
-    }    
-
-	auto getAngle = [](cv::Point2f &A, cv::Point2f &B, cv::Point2f &C) {
-		float c = cv::norm(A - B);
-		float a = cv::norm(A - C);
-		float b = cv::norm(B - C);
-		float tmp = (a*a + b * b - c * c) / (2.f * a * b);
-		return acosf(tmp);
-	};
-
-    auto checkInside = [getAngle](const std::vector<Point2Df>& contours, Point2f &ptToCheck) {
-		float sumAngles(0.f);
-		for (int i = 0; i < contours.size(); ++i) {
-            cv::Point2f pt1(contours[i].getX(), contours[i].getY());
-            cv::Point2f pt2(contours[(i + 1) % contours.size()].getX(), contours[(i + 1) % contours.size()].getY());
-			sumAngles += getAngle(pt1, pt2, ptToCheck);
-		}
-		
-		if (std::fabs(sumAngles - 2 * CV_PI) < 1e-4)
-			return true;
-		else
-			return false;
-	};
+    }
+
+    // the keypoints of the border of the mask are kept if they are inside the polygon or on its edges
+    kpts.erase(std::remove_if(kpts.begin(), kpts.end(), [&](const cv::KeyPoint & keypoint) {
+        cv::Point pixel(cvRound(keypoint.pt.x), cvRound(keypoint.pt.y));
+        if (!pixel.inside(cv::Rect(0, 0, m_mask.cols, m_mask.rows)) || m_mask.at<uchar>(pixel) == 0)
+            return true;
+        if (m_mask.at<uchar>(pixel) == MASK_INSIDE)
+            return false;
+        cv::Point2f pt(keypoint.pt.x * ratioInv + roi.x, keypoint.pt.y * ratioInv + roi.y);
+        return cv::pointPolygonTest(m_polygon, pt, false) < 0;
+    }), kpts.end());
+    if (m_type != "FEATURE_TO_TRACK" && m_nbDescriptors >= 0)
+        kptsFilter.retainBest(kpts, m_nbDescriptors);
 
     int kpID = 0;
 
     for(const auto &keypoint: kpts){
-        Point2f ptToCheck = keypoint.pt * ratioInv;
-        if (checkInside(contours, ptToCheck)) {
-            Keypoint kpa;
-			float px = keypoint.pt.x*ratioInv;
-			float py = keypoint.pt.y*ratioInv;
-			cv::Vec3b bgr{ 0, 0, 0 };
-			if (opencvImage.channels() == 3)
-				bgr = opencvImage.at<cv::Vec3b>((int)py, (int)px);
-			kpa.init(kpID++, px, py, bgr[2], bgr[1], bgr[0], keypoint.size, keypoint.angle, keypoint.response, keypoint.octave, keypoint.class_id);
-			keypoints.push_back(kpa);
-		}
+        Keypoint kpa;
+        float px = keypoint.pt.x*ratioInv + roi.x;
+        float py = keypoint.pt.y*ratioInv + roi.y;
+        cv::Vec3b bgr{ 0, 0, 0 };
+        if (opencvImage.channels() == 3)
+            bgr = opencvImage.at<cv::Vec3b>((int)py, (int)px);
+        kpa.init(kpID++, px, py, bgr[2], bgr[1], bgr[0], keypoint.size, keypoint.angle, keypoint.response, keypoint.octave, keypoint.class_id);
+        keypoints.push_back(kpa);
     }
 }
 
@@ -0,0 +1,261 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "SolARLatencyProfiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+namespace {
+
+// 8 sub-buckets per power of two, the durations below 8 ns have their own bucket
+const int SUB_BUCKET_BITS = 3;
+const int NB_SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+const int NB_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * NB_SUB_BUCKETS;
+// maximum number of names recorded by a thread
+const int MAX_NAMES = 64;
+
+int bucketIndex(uint64_t value)
+{
+    if (value < NB_SUB_BUCKETS)
+        return static_cast<int>(value);
+    int msb = 0;
+    for (uint64_t v = value >> 1; v != 0; v >>= 1)
+        msb++;
+    int shift = msb - SUB_BUCKET_BITS;
+    return (shift + 1) * NB_SUB_BUCKETS + static_cast<int>((value >> shift) & (NB_SUB_BUCKETS - 1));
+}
+
+// the middle of the range of durations of a bucket
+double bucketValue(int index)
+{
+    if (index < NB_SUB_BUCKETS)
+        return index;
+    int shift = index / NB_SUB_BUCKETS - 1;
+    return std::ldexp(NB_SUB_BUCKETS + index % NB_SUB_BUCKETS + 0.5, shift);
+}
+
+// the counters have a single writer, the owner thread, and are read by the dumps
+inline void add(std::atomic<uint64_t> & counter, uint64_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+struct Histogram
+{
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> buckets[NB_BUCKETS];
+
+    Histogram() { clear(); }
+
+    void clear()
+    {
+        count.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+        for (auto & bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct ThreadBuffer
+{
+    std::atomic<bool> inUse{true};
+    // the names and histograms before nbNames are published to the dumps
+    std::atomic<int> nbNames{0};
+    const char * names[MAX_NAMES];
+    std::unique_ptr<Histogram> histograms[MAX_NAMES];
+
+    // only called by the owner thread, the same name from two translation units may get two histograms merged by the dumps
+    Histogram * find(const char * name)
+    {
+        int n = nbNames.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; i++)
+            if (names[i] == name)
+                return histograms[i].get();
+        if (n == MAX_NAMES)
+            return nullptr;
+        names[n] = name;
+        histograms[n].reset(new Histogram());
+        nbNames.store(n + 1, std::memory_order_release);
+        return histograms[n].get();
+    }
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+};
+
+Registry & registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+std::atomic<bool> profilerEnabled{false};
+
+// gives the buffer of a thread back when it ends
+struct ThreadBufferHolder
+{
+    ThreadBuffer * buffer = nullptr;
+    ~ThreadBufferHolder()
+    {
+        if (buffer)
+            buffer->inUse.store(false, std::memory_order_release);
+    }
+};
+
+ThreadBuffer * threadBuffer()
+{
+    thread_local ThreadBufferHolder holder;
+    if (!holder.buffer)
+    {
+        Registry & reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto & buffer : reg.buffers)
+            if (!buffer->inUse.load(std::memory_order_acquire))
+            {
+                buffer->inUse.store(true, std::memory_order_relaxed);
+                holder.buffer = buffer.get();
+                break;
+            }
+        if (!holder.buffer)
+        {
+            reg.buffers.emplace_back(new ThreadBuffer());
+            holder.buffer = reg.buffers.back().get();
+        }
+    }
+    return holder.buffer;
+}
+
+struct Statistics
+{
+    uint64_t count = 0;
+    uint64_t total = 0;
+    uint64_t max = 0;
+    std::vector<uint64_t> buckets = std::vector<uint64_t>(NB_BUCKETS, 0);
+
+    double percentileMs(double percentile) const
+    {
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile * count)));
+        uint64_t cumulated = 0;
+        for (int i = 0; i < NB_BUCKETS; i++)
+        {
+            cumulated += buckets[i];
+            if (cumulated >= rank)
+                return std::min(bucketValue(i), static_cast<double>(max)) * 1e-6;
+        }
+        return max * 1e-6;
+    }
+};
+
+}
+
+void SolARLatencyProfiler::setEnabled(bool enabled)
+{
+    profilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool SolARLatencyProfiler::isEnabled()
+{
+    return profilerEnabled.load(std::memory_order_relaxed);
+}
+
+void SolARLatencyProfiler::record(const char * name, uint64_t nanoseconds)
+{
+    Histogram * histogram = threadBuffer()->find(name);
+    if (!histogram)
+        return;
+    add(histogram->count, 1);
+    add(histogram->total, nanoseconds);
+    if (nanoseconds > histogram->max.load(std::memory_order_relaxed))
+        histogram->max.store(nanoseconds, std::memory_order_relaxed);
+    add(histogram->buckets[bucketIndex(nanoseconds)], 1);
+}
+
+std::string SolARLatencyProfiler::toJSON()
+{
+    std::map<std::string, Statistics> statistics;
+    {
+        Registry & reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (const auto & buffer : reg.buffers)
+        {
+            int n = buffer->nbNames.load(std::memory_order_acquire);
+            for (int i = 0; i < n; i++)
+            {
+                const Histogram & histogram = *buffer->histograms[i];
+                Statistics & stats = statistics[buffer->names[i]];
+                stats.count += histogram.count.load(std::memory_order_relaxed);
+                stats.total += histogram.total.load(std::memory_order_relaxed);
+                stats.max = std::max(stats.max, histogram.max.load(std::memory_order_relaxed));
+                for (int j = 0; j < NB_BUCKETS; j++)
+                    stats.buckets[j] += histogram.buckets[j].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::ostringstream json;
+    json << "{";
+    bool first = true;
+    for (const auto & entry : statistics)
+    {
+        const Statistics & stats = entry.second;
+        if (stats.count == 0)
+            continue;
+        json << (first ? "\n" : ",\n") << "  \"" << entry.first << "\": {"
+             << "\"count\": " << stats.count
+             << ", \"mean_ms\": " << stats.total * 1e-6 / stats.count
+             << ", \"p50_ms\": " << stats.percentileMs(0.50)
+             << ", \"p95_ms\": " << stats.percentileMs(0.95)
+             << ", \"p99_ms\": " << stats.percentileMs(0.99)
+             << ", \"max_ms\": " << stats.max * 1e-6 << "}";
+        first = false;
+    }
+    json << (first ? "}" : "\n}");
+    return json.str();
+}
+
+void SolARLatencyProfiler::reset()
+{
+    Registry & reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto & buffer : reg.buffers)
+    {
+        int n = buffer->nbNames.load(std::memory_order_acquire);
+        for (int i = 0; i < n; i++)
+            buffer->histograms[i]->clear();
+    }
+}
+
+}
+}
+}
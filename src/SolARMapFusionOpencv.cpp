@@ -15,8 +15,12 @@
  */
 
 #include "SolARMapFusionOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 namespace xpcf = org::bcom::xpcf;
 
@@ -29,13 +33,64 @@ using namespace api::storage;
 namespace MODULES {
 namespace OPENCV {
 
+namespace {
+const uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+const int MAX_NB_CANDIDATES = 30;
+
+// size of a flat table indexed by the ids of the given map elements
+template <class T>
+size_t idTableSize(const std::vector<SRef<T>> & elements)
+{
+	uint32_t maxElementId = 0;
+	for (const auto &elt : elements)
+		maxElementId = std::max(maxElementId, elt->getId());
+	return elements.empty() ? 0 : static_cast<size_t>(maxElementId) + 1;
+}
+
+// gather cloud point positions (N x 3 float) and descriptors (one row per point) into contiguous matrices
+// the points without a descriptor or whose descriptor differs in size or type from the first one are skipped, indices gives the cloud point of each row
+void gatherCloudPoints(const std::vector<SRef<CloudPoint>> & cloudPoints, cv::Mat & points, cv::Mat & descriptors, std::vector<uint32_t> & indices)
+{
+	indices.clear();
+	SRef<DescriptorBuffer> reference;
+	for (uint32_t i = 0; i < cloudPoints.size(); ++i) {
+		SRef<DescriptorBuffer> desc = cloudPoints[i]->getDescriptor();
+		if (!desc || desc->getNbDescriptors() == 0)
+			continue;
+		if (!reference)
+			reference = desc;
+		else if ((desc->getNbElements() != reference->getNbElements()) || (desc->getDescriptorDataType() != reference->getDescriptorDataType()))
+			continue;
+		indices.push_back(i);
+	}
+	if (indices.size() != cloudPoints.size())
+		LOG_WARNING("{} cloud points without a descriptor of the same size and type as the others are ignored by the map fusion", cloudPoints.size() - indices.size());
+	points.create(static_cast<int>(indices.size()), 3, CV_32F);
+	if (!reference) {
+		descriptors.release();
+		return;
+	}
+	descriptors.create(points.rows, reference->getNbElements(), SolAROpenCVHelper::deduceOpenDescriptorCVType(reference->getDescriptorDataType()));
+	for (int i = 0; i < points.rows; ++i) {
+		const SRef<CloudPoint> &cp = cloudPoints[indices[i]];
+		float* pt = points.ptr<float>(i);
+		pt[0] = cp->getX();
+		pt[1] = cp->getY();
+		pt[2] = cp->getZ();
+		std::memcpy(descriptors.ptr(i), cp->getDescriptor()->data(), descriptors.cols * descriptors.elemSize());
+	}
+}
+}
+
 SolARMapFusionOpencv::SolARMapFusionOpencv() :ConfigurableBase(xpcf::toUUID<SolARMapFusionOpencv>())
 {
 	declareInterface<IMapFusion>(this);
 	declareInjectable<api::geom::I3DTransform>(m_transform3D);
-	declareInjectable<api::features::IDescriptorMatcher>(m_matcher);
+	declareInjectable<api::features::IDescriptorMatcher>(m_matcher, true);
 	declareInjectable<api::solver::pose::I3DTransformSACFinderFrom3D3D>(m_estimator3D);
 	declareProperty("radius", m_radius);
+	declareProperty("distanceRatio", m_distanceRatio);
+	declareProperty("profiling", m_profiling);
 	LOG_DEBUG(" SolARMapFusionOpencv constructor")
 }
 
@@ -46,6 +101,7 @@ SolARMapFusionOpencv::~SolARMapFusionOpencv()
 
 FrameworkReturnCode SolARMapFusionOpencv::merge(SRef<IMapper> map, SRef<IMapper> globalMap, Transform3Df & transform, uint32_t & nbMatches, float & error)
 {
+	SolARScopedTimer timer("SolARMapFusionOpencv::merge", m_profiling != 0);
 	/// Transform local map to global map
 	m_transform3D->transform(transform, map);
 
@@ -69,40 +125,23 @@ FrameworkReturnCode SolARMapFusionOpencv::merge(SRef<IMapper> map, SRef<IMapper>
 	keyframeMananger->getAllKeyframes(keyframes);
 	globalPointcloudManager->getAllPoints(globalCloudPoints);
 	globalKeyframeMananger->getAllKeyframes(globalKeyframes);
-	// init kd tree of global point cloud
-	std::vector<cv::Point3f> pointsForSearch;
-	for (auto &cp : globalCloudPoints)
-		pointsForSearch.push_back(cv::Point3f(cp->getX(), cp->getY(), cp->getZ()));
-	cv::flann::KDTreeIndexParams indexParams;
-	cv::flann::Index kdtree(cv::Mat(pointsForSearch).reshape(1), indexParams);
+	// gather positions and descriptors of both point clouds
+	cv::Mat points, descriptors, globalPoints, globalDescriptors;
+	std::vector<uint32_t> indices, globalIndices;
+	gatherCloudPoints(cloudPoints, points, descriptors, indices);
+	gatherCloudPoints(globalCloudPoints, globalPoints, globalDescriptors, globalIndices);
+	if (!descriptors.empty() && !globalDescriptors.empty()
+		&& ((descriptors.cols != globalDescriptors.cols) || (descriptors.type() != globalDescriptors.type()))) {
+		LOG_ERROR("The descriptors of the map and of the global map differ in size or type");
+		return FrameworkReturnCode::_ERROR_;
+	}
 	// find correspondences for each point
+	std::vector<std::pair<uint32_t, uint32_t>> duplicatedIndices;
+	findDuplicates(points, descriptors, globalPoints, globalDescriptors, m_radius, m_distanceRatio, duplicatedIndices);
 	std::vector < std::pair<SRef<CloudPoint>, SRef<CloudPoint>>> duplicatedCPs; // first is local CP, second is global CP
-	std::vector<bool> checkMatches(globalCloudPoints.size(), true);
-	for (auto &cp : cloudPoints) {
-		// find point by 3D distance
-		std::vector<int> idxCandidates;
-		std::vector<float> dists;
-		std::vector<float> query = { cp->getX(), cp->getY(), cp->getZ() };
-		kdtree.radiusSearch(query, idxCandidates, dists, m_radius, 30);
-		std::vector<SRef<DescriptorBuffer>> desCandidates;
-		std::vector<int> idxBestCandidates;
-		for (const auto &idx : idxCandidates) {
-			if ((idx != 0) && checkMatches[idx]) {
-				desCandidates.push_back(globalCloudPoints[idx]->getDescriptor());
-				idxBestCandidates.push_back(idx);
-			}
-		}
-		// filter by descriptor distance
-		if (desCandidates.size() > 0) {
-			std::vector<DescriptorMatch> matches;
-			m_matcher->match(cp->getDescriptor(), desCandidates, matches);
-			if (matches.size() != 0) {
-				int idxMatch = matches[0].getIndexInDescriptorB();
-				checkMatches[idxBestCandidates[idxMatch]] = false;
-				duplicatedCPs.push_back(std::make_pair(cp, globalCloudPoints[idxBestCandidates[idxMatch]]));
-			}
-		}
-	}	
+	duplicatedCPs.reserve(duplicatedIndices.size());
+	for (const auto &it : duplicatedIndices)
+		duplicatedCPs.push_back(std::make_pair(cloudPoints[indices[it.first]], globalCloudPoints[globalIndices[it.second]]));
 
 	/// Estimate transform2
 	std::vector<Point3Df> firstPts3D, secondPts3D;
@@ -144,6 +183,7 @@ FrameworkReturnCode SolARMapFusionOpencv::merge(SRef<IMapper> map, SRef<IMapper>
 	float error;
 	if (isRefineTransform)
 		return this->merge(map, globalMap, transform, nbMatches, error);
+	SolARScopedTimer timer("SolARMapFusionOpencv::merge", m_profiling != 0);
 	// transform map
 	m_transform3D->transform(transform, map);
 	// fuse local map into global map
@@ -151,6 +191,63 @@ FrameworkReturnCode SolARMapFusionOpencv::merge(SRef<IMapper> map, SRef<IMapper>
 	return FrameworkReturnCode::_SUCCESS;
 }
 
+void SolARMapFusionOpencv::findDuplicates(const cv::Mat & points, const cv::Mat & descriptors, const cv::Mat & globalPoints, const cv::Mat & globalDescriptors, float radius, float distanceRatio, std::vector<std::pair<uint32_t, uint32_t>>& duplicatedIndices, bool exactSearch)
+{
+	duplicatedIndices.clear();
+	if (points.empty() || globalPoints.empty() || descriptors.empty() || globalDescriptors.empty())
+		return;
+	// init kd tree of global point cloud, a single tree searched without limit of checks gives the exact neighbors
+	cv::flann::Index kdtree(globalPoints, exactSearch ? cv::flann::KDTreeIndexParams(1) : cv::flann::KDTreeIndexParams());
+	cv::flann::SearchParams searchParams(exactSearch ? cvflann::FLANN_CHECKS_UNLIMITED : 32);
+	int normType = descriptors.depth() == CV_8U ? cv::NORM_HAMMING : cv::NORM_L2;
+
+	// best global candidate of each local point, computed independently for each point
+	const int nbPoints = points.rows;
+	std::vector<int> bestIndices(nbPoints, -1);
+	std::vector<float> bestDistances(nbPoints, std::numeric_limits<float>::max());
+	cv::parallel_for_(cv::Range(0, nbPoints), [&](const cv::Range& range) {
+		std::vector<int> idxCandidates;
+		std::vector<float> dists;
+		for (int i = range.start; i < range.end; ++i) {
+			// find point by 3D distance
+			int nbCandidates = kdtree.radiusSearch(points.row(i), idxCandidates, dists, radius, MAX_NB_CANDIDATES, searchParams);
+			nbCandidates = std::min(nbCandidates, static_cast<int>(idxCandidates.size()));
+			// filter by descriptor distance
+			int bestIdx = -1;
+			float bestDist = std::numeric_limits<float>::max();
+			float secondBestDist = std::numeric_limits<float>::max();
+			for (int j = 0; j < nbCandidates; ++j) {
+				int idx = idxCandidates[j];
+				float dist = static_cast<float>(cv::norm(descriptors.row(i), globalDescriptors.row(idx), normType));
+				if ((dist < bestDist) || ((dist == bestDist) && (idx < bestIdx))) {
+					secondBestDist = bestDist;
+					bestDist = dist;
+					bestIdx = idx;
+				}
+				else if (dist < secondBestDist)
+					secondBestDist = dist;
+			}
+			if ((bestIdx >= 0) && ((nbCandidates == 1) || (bestDist < distanceRatio * secondBestDist))) {
+				bestIndices[i] = bestIdx;
+				bestDistances[i] = bestDist;
+			}
+		}
+	});
+
+	// resolve conflicts: a global point is kept for the local point with the best descriptor distance (the lowest index on ties)
+	std::vector<int> winners(globalPoints.rows, -1);
+	for (int i = 0; i < nbPoints; ++i) {
+		int idx = bestIndices[i];
+		if ((idx >= 0) && ((winners[idx] < 0) || (bestDistances[i] < bestDistances[winners[idx]])))
+			winners[idx] = i;
+	}
+	for (int i = 0; i < nbPoints; ++i) {
+		int idx = bestIndices[i];
+		if ((idx >= 0) && (winners[idx] == i))
+			duplicatedIndices.push_back(std::make_pair(static_cast<uint32_t>(i), static_cast<uint32_t>(idx)));
+	}
+}
+
 void SolARMapFusionOpencv::fuseMap(const std::vector<std::pair<uint32_t, uint32_t>>& cpOverlapIndices, SRef<IMapper> map, SRef<IMapper> globalMap)
 {
 	// get map
@@ -182,16 +279,20 @@ void SolARMapFusionOpencv::fuseMap(const std::vector<std::pair<uint32_t, uint32_
 		duplicatedCPsFiltered.push_back(std::make_pair(localCP, globalCP));
 	}
 
-	// add point cloud of local map to global map
-	std::map<uint32_t, uint32_t> idxCPOldNew;
-	for (const auto &cp : cloudPoints) {
-		uint32_t idxOld = cp->getId();
-		globalPointcloudManager->addPoint(cp);
-		idxCPOldNew[idxOld] = cp->getId();
-	}
+	// add point cloud of local map to global map in a single batch, remembering old ids in a flat table
+	std::vector<uint32_t> idxCPOldNew(idTableSize(cloudPoints), INVALID_ID);
+	std::vector<uint32_t> cpOldIds;
+	cpOldIds.reserve(cloudPoints.size());
+	for (const auto &cp : cloudPoints)
+		cpOldIds.push_back(cp->getId());
+	globalPointcloudManager->addPoints(cloudPoints);
+	for (size_t i = 0; i < cloudPoints.size(); ++i)
+		idxCPOldNew[cpOldIds[i]] = cloudPoints[i]->getId();
 
 	// add keyframes of local map to global map
-	std::map<uint32_t, uint32_t> idxKfOldNew;
+	std::vector<uint32_t> idxKfOldNew(idTableSize(keyframes), INVALID_ID);
+	std::vector<uint32_t> kfOldIds;
+	kfOldIds.reserve(keyframes.size());
 	for (const auto &kf : keyframes) {
 		// unscale keyframe pose
 		Transform3Df kfPose = kf->getPose();
@@ -204,24 +305,33 @@ void SolARMapFusionOpencv::fuseMap(const std::vector<std::pair<uint32_t, uint32_
 
 		uint32_t idxOld = kf->getId();
 		globalKeyframeMananger->addKeyframe(kf);
+		kfOldIds.push_back(idxOld);
 		idxKfOldNew[idxOld] = kf->getId();
 	}
 
 	// update visibilities of point cloud
+	// all old entries are removed before new ones are added, so that a new keyframe id equal to a not yet processed old id is never erased
+	std::vector<std::pair<uint32_t, uint32_t>> remapped;
 	for (const auto &cp : cloudPoints) {
 		std::map<uint32_t, uint32_t> visibilities = cp->getVisibility();
+		remapped.clear();
 		for (const auto &vi : visibilities) {
 			cp->removeVisibility(vi.first, vi.second);
-			cp->addVisibility(idxKfOldNew[vi.first], vi.second);
+			if (vi.first < idxKfOldNew.size() && idxKfOldNew[vi.first] != INVALID_ID)
+				remapped.push_back(std::make_pair(idxKfOldNew[vi.first], vi.second));
 		}
+		for (const auto &vi : remapped)
+			cp->addVisibility(vi.first, vi.second);
 	}
 
-	// update visibilities of keyframe
+	// update visibilities of keyframe (keypoint ids are unchanged, only the cloud point ids are overwritten)
 	for (const auto &kf : keyframes) {
 		std::map<uint32_t, uint32_t> visibilities = kf->getVisibility();
 		for (const auto &vi : visibilities) {
-			kf->removeVisibility(vi.first, vi.second);
-			kf->addVisibility(vi.first, idxCPOldNew[vi.second]);
+			if (vi.second < idxCPOldNew.size() && idxCPOldNew[vi.second] != INVALID_ID)
+				kf->addVisibility(vi.first, idxCPOldNew[vi.second]);
+			else
+				kf->removeVisibility(vi.first, vi.second);
 		}
 	}
 
@@ -230,13 +340,20 @@ void SolARMapFusionOpencv::fuseMap(const std::vector<std::pair<uint32_t, uint32_
 		globalKeyframeRetriever->addKeyframe(kf);
 	}
 
-	// add covisibility graph of local map to global map
-	for (auto it1 = idxKfOldNew.begin(); std::next(it1) != idxKfOldNew.end(); ++it1)
-		for (auto it2 = std::next(it1); it2 != idxKfOldNew.end(); ++it2) {
+	// add covisibility graph of local map to global map, only walking the existing edges of each keyframe
+	for (const auto &idOld1 : kfOldIds) {
+		std::vector<uint32_t> neighbors;
+		if (covisibilityGraph->getNeighbors(idOld1, 0.f, neighbors) != FrameworkReturnCode::_SUCCESS)
+			continue;
+		for (const auto &idOld2 : neighbors) {
+			// each undirected edge is visited once
+			if ((idOld2 <= idOld1) || (idOld2 >= idxKfOldNew.size()) || (idxKfOldNew[idOld2] == INVALID_ID))
+				continue;
 			float weight;
-			if (covisibilityGraph->getEdge(it1->first, it2->first, weight) == FrameworkReturnCode::_SUCCESS)
-				globalCovisibilityGraph->increaseEdge(it1->second, it2->second, weight);
+			if (covisibilityGraph->getEdge(idOld1, idOld2, weight) == FrameworkReturnCode::_SUCCESS)
+				globalCovisibilityGraph->increaseEdge(idxKfOldNew[idOld1], idxKfOldNew[idOld2], weight);
 		}
+	}
 
 	// Fuse duplicated cloud points
 	for (const auto &dup : duplicatedCPsFiltered) {
@@ -17,7 +17,9 @@
 #include "SolARMatchesOverlayOpencv.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
-#include "opencv2/video/video.hpp"
+#include "opencv2/imgproc.hpp"
+#include <cmath>
+#include <map>
 #include <random>
 
 namespace xpcf  = org::bcom::xpcf;
@@ -29,6 +31,30 @@ using namespace datastructure;
 namespace MODULES {
 namespace OPENCV {
 
+namespace {
+
+enum class OverlayMode { COLOR, RANDOM, FADING };
+
+const std::map<std::string, OverlayMode> overlayModes = {
+    {"COLOR", OverlayMode::COLOR},
+    {"RANDOM", OverlayMode::RANDOM},
+    {"FADING", OverlayMode::FADING}
+};
+
+// number of colors of the random and fading palettes
+const int PALETTE_SIZE = 256;
+
+// copies an image into its area of the canvas, downscaled to the size of the area
+void copyToCanvas(const cv::Mat & image, cv::Mat area)
+{
+    if (image.size() == area.size())
+        image.copyTo(area);
+    else
+        cv::resize(image, area, area.size(), 0, 0, cv::INTER_AREA);
+}
+
+}
+
 SolARMatchesOverlayOpencv::SolARMatchesOverlayOpencv():ConfigurableBase(xpcf::toUUID<SolARMatchesOverlayOpencv>())
 {
     declareInterface<api::display::IMatchesOverlay>(this);
@@ -38,556 +64,123 @@ SolARMatchesOverlayOpencv::SolARMatchesOverlayOpencv():ConfigurableBase(xpcf::to
     declarePropertySequence("color", m_color);
     declareProperty("mode", m_mode); // COLOR, RANDOM, FADING
     declareProperty("maxMatches", m_maxMatches);
+    declareProperty("lodStep", m_lodStep);
+    declareProperty("previewScale", m_previewScale);
+
+    // the random colors of a match stay the same from one frame to the next
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> uni(0,255);
+    m_randomPalette.resize(PALETTE_SIZE);
+    for (auto & color : m_randomPalette)
+        color = cv::Scalar(uni(rng), uni(rng), uni(rng));
+
+    // red for a null distance ratio, fading to yellow and then to green at m_minDistanceRatioGreen
+    m_fadingPalette.resize(PALETTE_SIZE);
+    for (int i = 0; i < PALETTE_SIZE; ++i)
+    {
+        float ratio = 2.f * i / (PALETTE_SIZE - 1);
+        if (ratio < 1.f)
+            m_fadingPalette[i] = cv::Scalar(0, cvRound(255 * ratio), 255);
+        else
+            m_fadingPalette[i] = cv::Scalar(0, 255, cvRound(255 * (2.f - ratio)));
+    }
 
     LOG_DEBUG(" SolARMatchesOverlayOpencv constructor");
 }
 
-void SolARMatchesOverlayOpencv::draw(const SRef<Image> image1, const SRef<Image> image2, SRef<Image> & outImage, const std::vector <Point2Df> & points_image1, const std::vector <Point2Df> & points_image2, const std::vector<DescriptorMatch> & matches)
+cv::Mat SolARMatchesOverlayOpencv::prepareCanvas(const SRef<Image> & image1, const SRef<Image> & image2, SRef<Image> & outImage) const
 {
+    float scale = getScale();
+    cv::Size size1(cvRound(image1->getWidth() * scale), cvRound(image1->getHeight() * scale));
+    cv::Size size2 = image2 ? cv::Size(cvRound(image2->getWidth() * scale), cvRound(image2->getHeight() * scale)) : cv::Size();
+    uint32_t width = size1.width + size2.width;
+    uint32_t height = std::max(size1.height, size2.height);
     if (outImage == nullptr)
     {
-        outImage = xpcf::utils::make_shared<Image>(image1->getWidth()+image2->getWidth(), std::max(image1->getHeight(), image2->getHeight()), image1->getImageLayout(), image1->getPixelOrder(), image1->getDataType());
+        outImage = xpcf::utils::make_shared<Image>(width, height, image1->getImageLayout(), image1->getPixelOrder(), image1->getDataType());
     }
-    else if ((outImage->getWidth() != image1->getWidth()+image2->getWidth()) || (outImage->getHeight() != std::max(image1->getHeight(), image2->getHeight())))
+    else if (outImage->getWidth() != width || outImage->getHeight() != height)
     {
-        outImage->setSize(image1->getWidth()+image2->getWidth(), std::max(image1->getHeight(), image2->getHeight()));
+        outImage->setSize(width, height);
     }
 
-    cv::Mat img1, img2, outImg;
-    Point2Df point1, point2;
-    int img1_width=image1->getWidth();
-
-    img1=SolAROpenCVHelper::mapToOpenCV(image1);
-    img2=SolAROpenCVHelper::mapToOpenCV(image2);
-    outImg=SolAROpenCVHelper::mapToOpenCV(outImage);
-
-    outImg.setTo(0);
-
-    img1.copyTo(outImg(cv::Rect(0, 0, img1_width, image1->getHeight())));
-    img2.copyTo(outImg(cv::Rect(img1_width, 0, image2->getWidth(), image2->getHeight())));
-
-    int nbPoints;
-
-    if (matches.empty())
+    // only the area below the shorter image is cleared
+    cv::Mat canvas = SolAROpenCVHelper::mapToOpenCV(outImage);
+    copyToCanvas(SolAROpenCVHelper::mapToOpenCV(image1), canvas(cv::Rect(cv::Point(0, 0), size1)));
+    if (size1.height < canvas.rows)
+        canvas(cv::Rect(0, size1.height, size1.width, canvas.rows - size1.height)).setTo(0);
+    if (image2)
     {
-        nbPoints = std::min(points_image1.size(), points_image2.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
-
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(i);
-                point2 = points_image2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(i);
-                point2 = points_image2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-            }
-        }
-        else if (m_mode.compare("FADING") == 0)
-        {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(i);
-                point2 = points_image2.at(i);
-                float distance = ((point1/image1->getWidth())-(point2/image2->getWidth())).norm();
-                std::vector<unsigned int> color = {0,0,0};
-
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
-        }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
-    }
-    else
-    {
-        nbPoints = static_cast<int>(matches.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
-
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(matches[i].getIndexInDescriptorA());
-                point2 = points_image2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(matches[i].getIndexInDescriptorA());
-                point2 = points_image2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-             }
-        }
-        else if (m_mode.compare("FADING") == 0)
-        {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(matches[i].getIndexInDescriptorA());
-                point2 = points_image2.at(matches[i].getIndexInDescriptorB());
-                float distance = ((point1/image1->getWidth())-(point2/image2->getWidth())).norm();
-                std::vector<unsigned int> color = {0,0,0};
-
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
-        }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
+        copyToCanvas(SolAROpenCVHelper::mapToOpenCV(image2), canvas(cv::Rect(cv::Point(size1.width, 0), size2)));
+        if (size2.height < canvas.rows)
+            canvas(cv::Rect(size1.width, size2.height, size2.width, canvas.rows - size2.height)).setTo(0);
     }
+    return canvas;
 }
 
-void SolARMatchesOverlayOpencv::draw(const SRef<Image> image1, const SRef<Image> image2, SRef<Image> & outImage, const std::vector <Keypoint> & points_image1, const std::vector<Keypoint> & points_image2, const std::vector<DescriptorMatch> & matches)
+template <class T>
+void SolARMatchesOverlayOpencv::drawMatches(cv::Mat & canvas, const std::vector<T> & points1, const std::vector<T> & points2, const std::vector<DescriptorMatch> & matches,
+                                            float offset, float normalization1, float normalization2) const
 {
-    if (outImage == nullptr)
+    auto mode = overlayModes.find(m_mode);
+    if (mode == overlayModes.end())
     {
-        outImage = xpcf::utils::make_shared<Image>(image1->getWidth()+image2->getWidth(), std::max(image1->getHeight(), image2->getHeight()), image1->getImageLayout(), image1->getPixelOrder(), image1->getDataType());
+        LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
+        return;
     }
-    else if ((outImage->getWidth() != image1->getWidth()+image2->getWidth()) || (outImage->getHeight() != std::max(image1->getHeight(), image2->getHeight())))
-    {
-        outImage->setSize(image1->getWidth()+image2->getWidth(), std::max(image1->getHeight(), image2->getHeight()));
-    }
-
-    cv::Mat img1, img2, outImg;
-    Point2Df point1, point2;
-    int img1_width=image1->getWidth();
-
-    img1=SolAROpenCVHelper::mapToOpenCV(image1);
-    img2=SolAROpenCVHelper::mapToOpenCV(image2);
-    outImg=SolAROpenCVHelper::mapToOpenCV(outImage);
 
-    outImg.setTo(0);
-
-    img1.copyTo(outImg(cv::Rect(0, 0, img1_width, image1->getHeight())));
-    img2.copyTo(outImg(cv::Rect(img1_width, 0, image2->getWidth(), image2->getHeight())));
-
-    int nbPoints;
-
-    if (matches.empty())
-    {
-        nbPoints = std::min(points_image1.size(), points_image2.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
-
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(i);
-                point2 = points_image2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(i);
-                point2 = points_image2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-            }
-        }
-        else if (m_mode.compare("FADING") == 0)
-        {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(i);
-                point2 = points_image2.at(i);
-                float distance = ((point1/image1->getWidth())-(point2/image2->getWidth())).norm();
-                std::vector<unsigned int> color = {0,0,0};
+    int nbPoints = matches.empty() ? static_cast<int>(std::min(points1.size(), points2.size())) : static_cast<int>(matches.size());
+    if (m_maxMatches >= 0)
+        nbPoints = std::min((int)m_maxMatches, nbPoints);
 
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
-        }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
-    }
-    else
+    float scale = getScale();
+    float fadingScale = (PALETTE_SIZE - 1) / m_minDistanceRatioGreen;
+    int step = std::max(m_lodStep, 1);
+    cv::Scalar color(m_color[2],m_color[1],m_color[0]);
+    for (int i = 0; i < nbPoints; i += step)
     {
-        nbPoints = static_cast<int>(matches.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
-
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(matches[i].getIndexInDescriptorA());
-                point2 = points_image2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(matches[i].getIndexInDescriptorA());
-                point2 = points_image2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-             }
-        }
-        else if (m_mode.compare("FADING") == 0)
+        const T & point1 = matches.empty() ? points1[i] : points1.at(matches[i].getIndexInDescriptorA());
+        const T & point2 = matches.empty() ? points2[i] : points2.at(matches[i].getIndexInDescriptorB());
+        if (mode->second == OverlayMode::RANDOM)
+            color = m_randomPalette[i % PALETTE_SIZE];
+        else if (mode->second == OverlayMode::FADING)
         {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points_image1.at(matches[i].getIndexInDescriptorA());
-                point2 = points_image2.at(matches[i].getIndexInDescriptorB());
-                float distance = ((point1/image1->getWidth())-(point2/image2->getWidth())).norm();
-                std::vector<unsigned int> color = {0,0,0};
-
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX()+img1_width,point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
+            float dx = point1.getX() * normalization1 - point2.getX() * normalization2;
+            float dy = point1.getY() * normalization1 - point2.getY() * normalization2;
+            float index = std::sqrt(dx * dx + dy * dy) * fadingScale;
+            color = m_fadingPalette[index < PALETTE_SIZE - 1 ? static_cast<int>(index) : PALETTE_SIZE - 1];
         }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
+        cv::line(canvas, cv::Point2f(point1.getX() * scale, point1.getY() * scale), cv::Point2f(point2.getX() * scale + offset, point2.getY() * scale), color, m_thickness);
     }
 }
 
-void SolARMatchesOverlayOpencv::draw(const SRef<Image> image, SRef<Image> & outImage, const std::vector <Point2Df> & points1, const std::vector <Point2Df> & points2, const std::vector<DescriptorMatch> & matches)
+float SolARMatchesOverlayOpencv::getScale() const
 {
-    if (outImage == nullptr)
-    {
-        outImage = xpcf::utils::make_shared<Image>(image->getWidth(), image->getHeight(), image->getImageLayout(), image->getPixelOrder(), image->getDataType());
-    }
-    else if (outImage->getWidth() != image->getWidth() || outImage->getHeight() != image->getHeight())
-    {
-        outImage->setSize(image->getWidth(), image->getHeight());
-    }
-
-    cv::Mat img, outImg;
-    Point2Df point1, point2;
-
-    img=SolAROpenCVHelper::mapToOpenCV(image);
-    outImg=SolAROpenCVHelper::mapToOpenCV(outImage);
-
-    outImg.setTo(0);
-
-    img.copyTo(outImg(cv::Rect(0, 0, image->getWidth(), image->getHeight())));
-
-    int nbPoints;
-
-    if (matches.empty())
-    {
-        nbPoints = std::min(points1.size(), points2.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
-
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(i);
-                point2 = points2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(i);
-                point2 = points2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-            }
-        }
-        else if (m_mode.compare("FADING") == 0)
-        {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(i);
-                point2 = points2.at(i);
-                float distance = (point1-point2).norm()/image->getWidth();
-                std::vector<unsigned int> color = {0,0,0};
-
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
-        }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
+    return (m_previewScale > 0.f && m_previewScale < 1.f) ? m_previewScale : 1.f;
+}
 
-    }
-    else
-    {
-        nbPoints = static_cast<int>(matches.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
+void SolARMatchesOverlayOpencv::draw(const SRef<Image> image1, const SRef<Image> image2, SRef<Image> & outImage, const std::vector <Point2Df> & points_image1, const std::vector <Point2Df> & points_image2, const std::vector<DescriptorMatch> & matches)
+{
+    cv::Mat canvas = prepareCanvas(image1, image2, outImage);
+    drawMatches(canvas, points_image1, points_image2, matches, static_cast<float>(cvRound(image1->getWidth() * getScale())), 1.f / image1->getWidth(), 1.f / image2->getWidth());
+}
 
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(matches[i].getIndexInDescriptorA());
-                point2 = points2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(matches[i].getIndexInDescriptorA());
-                point2 = points2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-             }
-        }
-        else if (m_mode.compare("FADING") == 0)
-        {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(matches[i].getIndexInDescriptorA());
-                point2 = points2.at(matches[i].getIndexInDescriptorB());
-                float distance = (point1-point2).norm()/image->getWidth();
-                std::vector<unsigned int> color = {0,0,0};
+void SolARMatchesOverlayOpencv::draw(const SRef<Image> image1, const SRef<Image> image2, SRef<Image> & outImage, const std::vector <Keypoint> & points_image1, const std::vector<Keypoint> & points_image2, const std::vector<DescriptorMatch> & matches)
+{
+    cv::Mat canvas = prepareCanvas(image1, image2, outImage);
+    drawMatches(canvas, points_image1, points_image2, matches, static_cast<float>(cvRound(image1->getWidth() * getScale())), 1.f / image1->getWidth(), 1.f / image2->getWidth());
+}
 
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
-        }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
-    }
+void SolARMatchesOverlayOpencv::draw(const SRef<Image> image, SRef<Image> & outImage, const std::vector <Point2Df> & points1, const std::vector <Point2Df> & points2, const std::vector<DescriptorMatch> & matches)
+{
+    cv::Mat canvas = prepareCanvas(image, nullptr, outImage);
+    drawMatches(canvas, points1, points2, matches, 0.f, 1.f / image->getWidth(), 1.f / image->getWidth());
 }
 
 void SolARMatchesOverlayOpencv::draw(const SRef<Image> image, SRef<Image> & outImage, const std::vector <Keypoint> & points1, const std::vector <Keypoint> & points2, const std::vector<DescriptorMatch> & matches)
 {
-    if (outImage == nullptr)
-    {
-        outImage = xpcf::utils::make_shared<Image>(image->getWidth(), image->getHeight(), image->getImageLayout(), image->getPixelOrder(), image->getDataType());
-    }
-    else if (outImage->getWidth() != image->getWidth() || outImage->getHeight() != image->getHeight())
-    {
-        outImage->setSize(image->getWidth(), image->getHeight());
-    }
-
-    cv::Mat img, outImg;
-    Point2Df point1, point2;
-
-    img=SolAROpenCVHelper::mapToOpenCV(image);
-    outImg=SolAROpenCVHelper::mapToOpenCV(outImage);
-
-    outImg.setTo(0);
-
-    img.copyTo(outImg(cv::Rect(0, 0, image->getWidth(), image->getHeight())));
-
-    int nbPoints;
-
-    if (matches.empty())
-    {
-        nbPoints = std::min(points1.size(), points2.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
-
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(i);
-                point2 = points2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(i);
-                point2 = points2.at(i);
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-            }
-        }
-        else if (m_mode.compare("FADING") == 0)
-        {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(i);
-                point2 = points2.at(i);
-                float distance = (point1-point2).norm()/image->getWidth();
-                std::vector<unsigned int> color = {0,0,0};
-
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
-        }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
-
-    }
-    else
-    {
-        nbPoints = static_cast<int>(matches.size());
-        if (m_maxMatches >= 0)
-            nbPoints = std::min((int)m_maxMatches, nbPoints);
-
-        if (m_mode.compare("COLOR") == 0)
-        {
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(matches[i].getIndexInDescriptorA());
-                point2 = points2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(m_color[2],m_color[1],m_color[0]),m_thickness);
-            }
-        }
-        else if (m_mode.compare("RANDOM") == 0)
-        {
-            std::random_device rd;     // only used once to initialise (seed) engine
-            std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
-            std::uniform_int_distribution<int> uni(0,255); // guaranteed unbiased
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(matches[i].getIndexInDescriptorA());
-                point2 = points2.at(matches[i].getIndexInDescriptorB());
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(uni(rng),uni(rng),uni(rng)),m_thickness);
-             }
-        }
-        else if (m_mode.compare("FADING") == 0)
-        {
-            float halfMinDistanceRatioGreen = m_minDistanceRatioGreen/2.0f;
-            for (int i = 0;i<nbPoints;++i){
-                point1 = points1.at(matches[i].getIndexInDescriptorA());
-                point2 = points2.at(matches[i].getIndexInDescriptorB());
-                float distance = (point1-point2).norm()/image->getWidth();
-                std::vector<unsigned int> color = {0,0,0};
-
-                if (distance >= m_minDistanceRatioGreen)
-                    color = {0, 255, 0};
-                else
-                {
-                    if (distance < halfMinDistanceRatioGreen)
-                    {
-                        color[0] = 255;
-                        color[1] = (unsigned int)(255*distance/halfMinDistanceRatioGreen);
-                    }
-                    else
-                    {
-                        color[0] = (unsigned int)(255*(m_minDistanceRatioGreen - distance)/halfMinDistanceRatioGreen);
-                        color[1] = 255;
-                    }
-                }
-                cv::line(outImg,cv::Point2f(point1.getX(), point1.getY()),cv::Point2f(point2.getX(),point2.getY()),cv::Scalar(color[2],color[1],color[0]),m_thickness);
-            }
-        }
-        else
-            LOG_WARNING ("For SolARMatchesOverlayOpenCV, mode should be either COLOR, RANDOM or FADING");
-    }
+    cv::Mat canvas = prepareCanvas(image, nullptr, outImage);
+    drawMatches(canvas, points1, points2, matches, 0.f, 1.f / image->getWidth(), 1.f / image->getWidth());
 }
 
 }
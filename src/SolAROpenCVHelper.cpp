@@ -16,6 +16,9 @@
 
 #include "SolAROpenCVHelper.h"
 #include <map>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <opencv2/core.hpp>
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
@@ -67,6 +70,14 @@ cv::Mat SolAROpenCVHelper::mapToOpenCV (SRef<Image> imgSrc)
     return imgCV;
 }
 
+void SolAROpenCVHelper::prepareImage(uint32_t width, uint32_t height, Image::ImageLayout layout, Image::PixelOrder pixelOrder, Image::DataType dataType, SRef<Image>& image)
+{
+    if (!image || image->getImageLayout() != layout || image->getPixelOrder() != pixelOrder || image->getDataType() != dataType)
+        image = utils::make_shared<Image>(width, height, layout, pixelOrder, dataType);
+    else if (image->getWidth() != width || image->getHeight() != height)
+        image->setSize(width, height);
+}
+
 FrameworkReturnCode SolAROpenCVHelper::convertToSolar (cv::Mat&  imgSrc, SRef<Image>& imgDest)
 {
     if (cv2solarTypeConvertMap.find(imgSrc.type()) == cv2solarTypeConvertMap.end() || imgSrc.empty()) {
@@ -98,6 +109,50 @@ std::vector<cv::Point2f> SolAROpenCVHelper::convertToOpenCV (const Contour2Df &c
     return output;
 }
 
+// the SolAR points are mapped to OpenCV points without copy, they must only hold their float coordinates
+static_assert(sizeof(Point2Df) == sizeof(cv::Point2f), "Point2Df must have the layout of cv::Point2f to be mapped to OpenCV");
+static_assert(sizeof(Point3Df) == sizeof(cv::Point3f), "Point3Df must have the layout of cv::Point3f to be mapped to OpenCV");
+
+cv::Mat SolAROpenCVHelper::mapToOpenCV (const std::vector<Point2Df> & points)
+{
+    if (points.empty())
+        return cv::Mat(0, 1, CV_32FC2);
+    return cv::Mat(static_cast<int>(points.size()), 1, CV_32FC2, (void *)points.data());
+}
+
+cv::Mat SolAROpenCVHelper::mapToOpenCV (const std::vector<Point3Df> & points)
+{
+    if (points.empty())
+        return cv::Mat(0, 1, CV_32FC3);
+    return cv::Mat(static_cast<int>(points.size()), 1, CV_32FC3, (void *)points.data());
+}
+
+template <typename T>
+static double chainLength (const cv::Point_<T>* points, int count)
+{
+    double length = 0.;
+    for (int i = 0; i < count; i++)
+    {
+        const cv::Point_<T> & p1 = points[i];
+        const cv::Point_<T> & p2 = points[(i + 1) % count];
+        length += std::max(std::abs(p2.x - p1.x), std::abs(p2.y - p1.y));
+    }
+    return length;
+}
+
+double SolAROpenCVHelper::contourChainLength (cv::InputArray contour)
+{
+    cv::Mat points = contour.getMat();
+    int count = points.checkVector(2);
+    if (count <= 0)
+        return 0.;
+    if (points.depth() == CV_32S)
+        return chainLength(points.ptr<cv::Point>(), count);
+    if (points.depth() == CV_32F)
+        return chainLength(points.ptr<cv::Point2f>(), count);
+    return 0.;
+}
+
 // Compute the intersection between a edge and a rectangle
 bool Liang_Barsky (cv::Point2f& p1, cv::Point2f& p2, Rectanglei& rect, cv::Point2f& p1_out, cv::Point2f& p2_out)
 {
@@ -15,9 +15,14 @@
  */
 
 #include "SolAROpticalFlowPyrLKOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
 namespace xpcf  = org::bcom::xpcf;
 
 XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolAROpticalFlowPyrLKOpencv)
@@ -28,6 +33,13 @@ using namespace api::tracking;
 namespace MODULES {
 namespace OPENCV {
 
+namespace {
+
+// the number of points tracked forward and backward by a task in the forward-backward mode
+const size_t POINTS_PER_CHUNK = 64;
+
+}
+
 SolAROpticalFlowPyrLKOpencv::SolAROpticalFlowPyrLKOpencv():ConfigurableBase(xpcf::toUUID<SolAROpticalFlowPyrLKOpencv>())
 {
     declareInterface<IOpticalFlowEstimator>(this);
@@ -37,6 +49,9 @@ SolAROpticalFlowPyrLKOpencv::SolAROpticalFlowPyrLKOpencv():ConfigurableBase(xpcf
     declareProperty("minEigenThreshold", m_minEigenThreshold);
     declareProperty("maxSearchIterations", m_maxSearchIterations);
     declareProperty("searchWindowAccuracy",m_searchWindowAccuracy);
+    declareProperty("forwardBackward", m_forwardBackward);
+    declareProperty("maxForwardBackwardError", m_maxForwardBackwardError);
+    declareProperty("profiling", m_profiling);
 
     LOG_DEBUG(" SolAROpticalFlowPyrLKOpencv constructor")
 }
@@ -46,30 +61,6 @@ SolAROpticalFlowPyrLKOpencv::~SolAROpticalFlowPyrLKOpencv()
     LOG_DEBUG(" SolAROpticalFlowPyrLKOpencv destructor")
 }
 
-template <class T> std::vector<cv::Point2f> fillcvpoints(const std::vector<T> & points)
-{
-
-}
-
-template <>
-inline std::vector<cv::Point2f> fillcvpoints(const std::vector<Point2Df> & points)
-{
-
-    std::vector<cv::Point2f> cv_points;
-    for (auto point : points)
-        cv_points.push_back(cv::Point2f(point.getX(), point.getY()));
-    return cv_points;
-}
-
-template <>
-inline std::vector<cv::Point2f> fillcvpoints(const std::vector<Keypoint> & points)
-{
-    std::vector<cv::Point2f> cv_points;
-    for (auto point : points)
-        cv_points.push_back(cv::Point2f(point.getX(), point.getY()));
-    return cv_points;
-}
-
 FrameworkReturnCode SolAROpticalFlowPyrLKOpencv::estimate(
                 const SRef<Image> previousImage,
                 const SRef<Image> currentImage,
@@ -78,8 +69,11 @@ FrameworkReturnCode SolAROpticalFlowPyrLKOpencv::estimate(
                 std::vector<unsigned char> & status,
                 std::vector<float> & error)
 {
-    std::vector<cv::Point2f> cv_points = fillcvpoints (pointsToTrack);
-    return estimate (previousImage, currentImage, cv_points, trackedPoints, status, error);
+    // the keypoints hold more than their coordinates, they are gathered in a buffer kept from one call to the next
+    m_points.resize(pointsToTrack.size());
+    for (size_t i = 0; i < pointsToTrack.size(); i++)
+        m_points[i] = cv::Point2f(pointsToTrack[i].getX(), pointsToTrack[i].getY());
+    return estimate (previousImage, currentImage, cv::Mat(m_points), trackedPoints, status, error);
 }
 
 FrameworkReturnCode SolAROpticalFlowPyrLKOpencv::estimate(
@@ -90,45 +84,128 @@ FrameworkReturnCode SolAROpticalFlowPyrLKOpencv::estimate(
                 std::vector<unsigned char> & status,
                 std::vector<float> & error)
 {
-    std::vector<cv::Point2f> cv_points = fillcvpoints (pointsToTrack);
-    return estimate (previousImage, currentImage, cv_points, trackedPoints, status, error);
+    // the tracked points are written over the points to track at each pyramid level, they are copied when they are the same
+    if (&pointsToTrack == &trackedPoints)
+        return estimate (previousImage, currentImage, SolAROpenCVHelper::mapToOpenCV(pointsToTrack).clone(), trackedPoints, status, error);
+    return estimate (previousImage, currentImage, SolAROpenCVHelper::mapToOpenCV(pointsToTrack), trackedPoints, status, error);
 }
 
 FrameworkReturnCode SolAROpticalFlowPyrLKOpencv::estimate(const SRef<Image> previousImage,
                                                           const SRef<Image> currentImage,
-                                                          const std::vector<cv::Point2f> & pointsToTrack,
+                                                          const cv::Mat & pointsToTrack,
                                                           std::vector<Point2Df> & trackedPoints,
                                                           std::vector<unsigned char> & status,
                                                           std::vector<float> & error)
 {
-    cv::Mat previousFrame, currentFrame;
-    if (previousImage->getImageLayout() == Image::ImageLayout::LAYOUT_GREY)
-        previousFrame = SolAR::MODULES::OPENCV::SolAROpenCVHelper::mapToOpenCV(previousImage);
-    else {
-        cv::Mat tempPreviousFrame = SolAR::MODULES::OPENCV::SolAROpenCVHelper::mapToOpenCV(previousImage);
-         cv::cvtColor(tempPreviousFrame, previousFrame, cv::COLOR_BGR2GRAY);
-    }
-
-    if (currentImage->getImageLayout() == Image::ImageLayout::LAYOUT_GREY)
-        currentFrame = SolAR::MODULES::OPENCV::SolAROpenCVHelper::mapToOpenCV(currentImage);
-    else {
-        cv::Mat tempCurrentFrame = SolAR::MODULES::OPENCV::SolAROpenCVHelper::mapToOpenCV(currentImage);
-         cv::cvtColor(tempCurrentFrame, currentFrame, cv::COLOR_BGR2GRAY);
-    }
-
-    std::vector<cv::Point2f> cv_trackedPoints;
+    SolARScopedTimer timer("SolAROpticalFlowPyrLKOpencv::estimate", m_profiling != 0);
+    cv::Mat previousSource = SolAROpenCVHelper::mapToOpenCV(previousImage);
+    cv::Mat currentSource = SolAROpenCVHelper::mapToOpenCV(currentImage);
+    cv::Size winSize(m_searchWinWidth, m_searchWinHeight);
+
+    // the pyramid of the current image of the last call is the one of the previous image of this call in a video stream
+    bool reusePyramid = winSize == m_pyramidWinSize && m_maxLevel == m_pyramidMaxLevel && sameContent(previousSource, m_lastSource);
+    if (!reusePyramid)
+        buildPyramid(previousImage, previousSource, m_previousPyramid);
+    buildPyramid(currentImage, currentSource, m_currentPyramid);
+    m_pyramidWinSize = winSize;
+    m_pyramidMaxLevel = m_maxLevel;
+
+    // the tracked points are written by OpenCV in the output vector
+    trackedPoints.resize(pointsToTrack.rows);
+    cv::Mat cv_trackedPoints = SolAROpenCVHelper::mapToOpenCV(trackedPoints);
 
     cv::TermCriteria termcrit(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, m_maxSearchIterations, m_searchWindowAccuracy);
     int flags = m_minEigenThreshold <=0 ? 0 : cv::OPTFLOW_LK_GET_MIN_EIGENVALS;
-    cv::calcOpticalFlowPyrLK(previousFrame, currentFrame, pointsToTrack, cv_trackedPoints, status, error, cv::Size(m_searchWinWidth, m_searchWinHeight), m_maxLevel, termcrit, flags, m_minEigenThreshold);
+    if (pointsToTrack.empty())
+    {
+        status.clear();
+        error.clear();
+    }
+    else if (m_forwardBackward)
+        trackForwardBackward(pointsToTrack, cv_trackedPoints, status, error, termcrit, flags);
+    else
+        cv::calcOpticalFlowPyrLK(m_previousPyramid, m_currentPyramid, pointsToTrack, cv_trackedPoints, status, error, winSize, m_maxLevel, termcrit, flags, m_minEigenThreshold);
 
-    trackedPoints.clear();
-    for (int i = 0; i < cv_trackedPoints.size(); i++)
-        trackedPoints.push_back(Point2Df(cv_trackedPoints[i].x, cv_trackedPoints[i].y));
+    // keep the current image and its pyramid for the next call
+    currentSource.copyTo(m_lastSource);
+    std::swap(m_previousPyramid, m_currentPyramid);
 
     return FrameworkReturnCode::_SUCCESS;
 }
 
+void SolAROpticalFlowPyrLKOpencv::trackForwardBackward(const cv::Mat & pointsToTrack,
+                                                       cv::Mat & trackedPoints,
+                                                       std::vector<unsigned char> & status,
+                                                       std::vector<float> & error,
+                                                       const cv::TermCriteria & termcrit,
+                                                       int flags)
+{
+    size_t nbPoints = pointsToTrack.rows;
+    const cv::Point2f * inputPoints = pointsToTrack.ptr<cv::Point2f>();
+    cv::Point2f * outputPoints = trackedPoints.ptr<cv::Point2f>();
+    status.resize(nbPoints);
+    error.resize(nbPoints);
+    cv::Size winSize(m_searchWinWidth, m_searchWinHeight);
+    int nbChunks = static_cast<int>((nbPoints + POINTS_PER_CHUNK - 1) / POINTS_PER_CHUNK);
+
+    // each chunk of points is tracked forward and then backward on the shared pyramids, the chunks are tracked in parallel
+    cv::parallel_for_(cv::Range(0, nbChunks), [&](const cv::Range & range) {
+        std::vector<cv::Point2f> points, forwardPoints, backwardPoints;
+        std::vector<unsigned char> forwardStatus, backwardStatus;
+        std::vector<float> forwardError, backwardError;
+        for (int chunk = range.start; chunk < range.end; chunk++)
+        {
+            size_t begin = chunk * POINTS_PER_CHUNK;
+            size_t end = std::min(begin + POINTS_PER_CHUNK, nbPoints);
+            points.assign(inputPoints + begin, inputPoints + end);
+            cv::calcOpticalFlowPyrLK(m_previousPyramid, m_currentPyramid, points, forwardPoints, forwardStatus, forwardError,
+                                     winSize, m_maxLevel, termcrit, flags, m_minEigenThreshold);
+            cv::calcOpticalFlowPyrLK(m_currentPyramid, m_previousPyramid, forwardPoints, backwardPoints, backwardStatus, backwardError,
+                                     winSize, m_maxLevel, termcrit, flags, m_minEigenThreshold);
+            for (size_t k = 0; k < points.size(); k++)
+            {
+                size_t i = begin + k;
+                outputPoints[i] = forwardPoints[k];
+                if (forwardStatus[k] && backwardStatus[k])
+                {
+                    error[i] = static_cast<float>(cv::norm(backwardPoints[k] - points[k]));
+                    status[i] = error[i] <= m_maxForwardBackwardError ? 1 : 0;
+                }
+                else
+                {
+                    error[i] = std::numeric_limits<float>::max();
+                    status[i] = 0;
+                }
+            }
+        }
+    });
+}
+
+void SolAROpticalFlowPyrLKOpencv::buildPyramid(const SRef<Image> image, const cv::Mat & source, std::vector<cv::Mat> & pyramid)
+{
+    cv::Mat grey;
+    if (image->getImageLayout() == Image::ImageLayout::LAYOUT_GREY)
+        grey = source;
+    else {
+        cv::cvtColor(source, m_grey, cv::COLOR_BGR2GRAY);
+        grey = m_grey;
+    }
+    // the derivatives are only used once the image becomes the previous one, the level 0 is copied so that the image can be released
+    cv::buildOpticalFlowPyramid(grey, pyramid, cv::Size(m_searchWinWidth, m_searchWinHeight), m_maxLevel, true,
+                                cv::BORDER_REFLECT_101, cv::BORDER_CONSTANT, false);
+}
+
+bool SolAROpticalFlowPyrLKOpencv::sameContent(const cv::Mat & image1, const cv::Mat & image2)
+{
+    if (image1.size() != image2.size() || image1.type() != image2.type() || image1.empty())
+        return false;
+    size_t rowSize = image1.cols * image1.elemSize();
+    for (int row = 0; row < image1.rows; row++)
+        if (std::memcmp(image1.ptr(row), image2.ptr(row), rowSize) != 0)
+            return false;
+    return true;
+}
+
 }
 }
 }  // end of namespace SolAR
@@ -19,6 +19,8 @@
 #include "opencv2/opencv.hpp"
 #include "core/Log.h"
 
+#include <map>
+
 namespace xpcf = org::bcom::xpcf;
 
 XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARPerspectiveControllerOpencv)
@@ -28,46 +30,42 @@ using namespace datastructure;
 namespace MODULES {
 namespace OPENCV {
 
+    static std::map<std::string, int> convertInterpolation = {{"LINEAR", cv::INTER_LINEAR},
+                                                              {"NEAREST", cv::INTER_NEAREST}};
+
     SolARPerspectiveControllerOpencv::SolARPerspectiveControllerOpencv():ConfigurableBase(xpcf::toUUID<SolARPerspectiveControllerOpencv>())
     {
         declareInterface<api::image::IPerspectiveController>(this);
         declareProperty("outputImageWidth", m_outputImageWidth);
         declareProperty("outputImageHeight", m_outputImageHeight);
+        declareProperty("interpolation", m_interpolation);
     }
 
-    FrameworkReturnCode SolARPerspectiveControllerOpencv::correct(const SRef<Image> inputImg, const Contour2Df & contour, SRef<Image> & outputImage)
+    xpcf::XPCFErrorCode SolARPerspectiveControllerOpencv::onConfigured()
     {
-        std::vector<cv::Point2f> points;
-        cv::Size patches_size(m_outputImageWidth, m_outputImageHeight);
-        std::vector<cv::Point2f> markerCorners2D;
-        markerCorners2D.push_back(cv::Point2f(0, 0));
-        markerCorners2D.push_back(cv::Point2f(m_outputImageWidth - 1, 0));
-        markerCorners2D.push_back(cv::Point2f(m_outputImageWidth - 1, m_outputImageHeight - 1));
-        markerCorners2D.push_back(cv::Point2f(0, m_outputImageHeight - 1));
-
-        cv::Mat cv_inputImg = SolAROpenCVHelper::mapToOpenCV(inputImg);
-          // For each contour, extract the patch
-        if (contour.size()>=4)
-
+        auto itr = convertInterpolation.find(m_interpolation);
+        if (itr == convertInterpolation.end())
         {
-            for(unsigned int j =0; j < 4; ++j)
-            {
-               points.push_back(cv::Point2f(contour[j].getX(),contour[j].getY()));
-            }
-                // Find the perspective transformation that brings current marker to rectangular form
-            cv::Mat markerTransform = cv::getPerspectiveTransform(points, markerCorners2D);
-                // Transform image to get a canonical marker image
-            cv::Mat cv_patch;
-            cv::warpPerspective(cv_inputImg, cv_patch, markerTransform, patches_size);
-            SolAROpenCVHelper::convertToSolar(cv_patch, outputImage);
-
-            return FrameworkReturnCode::_SUCCESS;
+            LOG_WARNING("Perspective controller interpolation {} does not exist, LINEAR is used", m_interpolation);
+            m_interpolationFlag = cv::INTER_LINEAR;
         }
         else
+            m_interpolationFlag = itr->second;
+        return xpcf::XPCFErrorCode::_SUCCESS;
+    }
+
+    FrameworkReturnCode SolARPerspectiveControllerOpencv::correct(const SRef<Image> inputImg, const Contour2Df & contour, SRef<Image> & outputImage)
+    {
+        if (inputImg == nullptr || contour.size() < 4 || m_outputImageWidth <= 0 || m_outputImageHeight <= 0)
         {
             outputImage = nullptr;
             return FrameworkReturnCode::_ERROR_;
         }
+        SolAROpenCVHelper::prepareImage(m_outputImageWidth, m_outputImageHeight, inputImg->getImageLayout(), Image::PixelOrder::INTERLEAVED, inputImg->getDataType(), outputImage);
+        m_destinations.resize(1);
+        m_destinations[0] = SolAROpenCVHelper::mapToOpenCV(outputImage);
+        warpPatches(SolAROpenCVHelper::mapToOpenCV(inputImg), std::vector<Contour2Df>(1, contour), m_destinations);
+        return FrameworkReturnCode::_SUCCESS;
     }
 
     FrameworkReturnCode SolARPerspectiveControllerOpencv::correct(const SRef<Image> inputImg, const std::vector<Contour2Df> & contours, std::vector<SRef<Image>> & patches)
@@ -82,43 +80,84 @@ namespace OPENCV {
             LOG_ERROR("The width or height of the output image for PerspectiveControllerOpenCV is null or negative");
             return FrameworkReturnCode::_ERROR_;
         }
-        std::vector<cv::Point2f> points;
-        cv::Size patches_size(m_outputImageWidth, m_outputImageHeight);
-        std::vector<cv::Point2f> markerCorners2D;
-        markerCorners2D.push_back(cv::Point2f(0, 0));
-        markerCorners2D.push_back(cv::Point2f(m_outputImageWidth - 1, 0));
-        markerCorners2D.push_back(cv::Point2f(m_outputImageWidth - 1, m_outputImageHeight - 1));
-        markerCorners2D.push_back(cv::Point2f(0, m_outputImageHeight - 1));
 
-        cv::Mat cv_inputImg = SolAROpenCVHelper::mapToOpenCV(inputImg);
-        patches.clear();
-          // For each contour, extract the patch
-        for (size_t i = 0; i<contours.size(); i++)
+        // The patches already allocated are overwritten
+        patches.resize(contours.size());
+        m_destinations.resize(contours.size());
+        for (size_t i = 0; i < contours.size(); i++)
         {
-            points.clear();
             // If the contour contains at least 4 points
             if (contours[i].size() >= 4)
             {
-                for(unsigned int j =0; j < 4; ++j)
-                {
-                   points.push_back(cv::Point2f((contours[i])[j].getX(),(contours[i])[j].getY()));
-                }
-                    // Find the perspective transformation that brings current marker to rectangular form
-                cv::Mat markerTransform = cv::getPerspectiveTransform(points, markerCorners2D);
-                    // Transform image to get a canonical marker image
-                cv::Mat cv_patch;
-                cv::warpPerspective(cv_inputImg, cv_patch, markerTransform, patches_size);
-                SRef<Image> patch;
-                SolAROpenCVHelper::convertToSolar(cv_patch, patch);
-                patches.push_back(patch);
+                SolAROpenCVHelper::prepareImage(m_outputImageWidth, m_outputImageHeight, inputImg->getImageLayout(), Image::PixelOrder::INTERLEAVED, inputImg->getDataType(), patches[i]);
+                m_destinations[i] = SolAROpenCVHelper::mapToOpenCV(patches[i]);
             }
             // else add a empty image to ensure the order of contours and output corrected images.
             else
-                patches.push_back(nullptr);
+            {
+                patches[i] = nullptr;
+                m_destinations[i].release();
+            }
         }
+        warpPatches(SolAROpenCVHelper::mapToOpenCV(inputImg), contours, m_destinations);
         return FrameworkReturnCode::_SUCCESS;
     }
 
+    FrameworkReturnCode SolARPerspectiveControllerOpencv::correct(const SRef<Image> inputImg, const std::vector<Contour2Df> & contours, SRef<Image> & strip)
+    {
+        if (inputImg == nullptr)
+        {
+            LOG_ERROR("The input image for PerspectiveControllerOpenCV is null");
+            return FrameworkReturnCode::_ERROR_;
+        }
+        if (m_outputImageWidth <=0 || m_outputImageHeight <=0)
+        {
+            LOG_ERROR("The width or height of the output image for PerspectiveControllerOpenCV is null or negative");
+            return FrameworkReturnCode::_ERROR_;
+        }
+
+        // The patches are stacked vertically, so that each of them is contiguous in memory
+        SolAROpenCVHelper::prepareImage(m_outputImageWidth, m_outputImageHeight * static_cast<uint32_t>(contours.size()), inputImg->getImageLayout(),
+                                        Image::PixelOrder::INTERLEAVED, inputImg->getDataType(), strip);
+        if (contours.empty())
+            return FrameworkReturnCode::_SUCCESS;
+        cv::Mat cv_strip = SolAROpenCVHelper::mapToOpenCV(strip);
+        m_destinations.resize(contours.size());
+        for (size_t i = 0; i < contours.size(); i++)
+        {
+            m_destinations[i] = cv_strip.rowRange(static_cast<int>(i) * m_outputImageHeight, static_cast<int>(i + 1) * m_outputImageHeight);
+            if (contours[i].size() < 4)
+                m_destinations[i].setTo(0);
+        }
+        warpPatches(SolAROpenCVHelper::mapToOpenCV(inputImg), contours, m_destinations);
+        return FrameworkReturnCode::_SUCCESS;
+    }
+
+    void SolARPerspectiveControllerOpencv::warpPatches(const cv::Mat & inputImg, const std::vector<Contour2Df> & contours, std::vector<cv::Mat> & destinations)
+    {
+        std::vector<cv::Point2f> markerCorners2D;
+        markerCorners2D.push_back(cv::Point2f(0, 0));
+        markerCorners2D.push_back(cv::Point2f(m_outputImageWidth - 1, 0));
+        markerCorners2D.push_back(cv::Point2f(m_outputImageWidth - 1, m_outputImageHeight - 1));
+        markerCorners2D.push_back(cv::Point2f(0, m_outputImageHeight - 1));
+
+        // Each contour is warped into its own destination, the contours are shared between the threads
+        cv::parallel_for_(cv::Range(0, static_cast<int>(contours.size())), [&](const cv::Range & range) {
+            std::vector<cv::Point2f> points(4);
+            for (int i = range.start; i < range.end; i++)
+            {
+                if (contours[i].size() < 4)
+                    continue;
+                for (unsigned int j = 0; j < 4; ++j)
+                    points[j] = cv::Point2f((contours[i])[j].getX(), (contours[i])[j].getY());
+                // Find the perspective transformation that brings current marker to rectangular form
+                cv::Mat markerTransform = cv::getPerspectiveTransform(points, markerCorners2D);
+                // Transform image to get a canonical marker image, the destination is not reallocated as it has the right size and type
+                cv::warpPerspective(inputImg, destinations[i], markerTransform, destinations[i].size(), m_interpolationFlag);
+            }
+        });
+    }
+
 }
 }
 }  // end of namespace Solar
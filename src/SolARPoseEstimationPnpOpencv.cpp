@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "SolARPoseEstimationPnpOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 #include "opencv2/calib3d/calib3d.hpp"
@@ -46,6 +47,7 @@ SolARPoseEstimationPnpOpencv::SolARPoseEstimationPnpOpencv():ConfigurableBase(xp
     declareProperty("confidence", m_confidence);
     declareProperty("minNbInliers", m_NbInliersToValidPose);
     declareProperty("method", m_method);
+    declareProperty("profiling", m_profiling);
 
     m_camMatrix.create(3, 3, CV_32FC1);
     m_camDistorsion.create(5, 1, CV_32FC1);
@@ -61,6 +63,7 @@ FrameworkReturnCode SolARPoseEstimationPnpOpencv::estimate( const std::vector<Po
                                                             const std::vector<Point3Df> & worldPoints,
                                                             Transform3Df & pose,
                                                             const Transform3Df initialPose) {
+    SolARScopedTimer timer("SolARPoseEstimationPnpOpencv::estimate", m_profiling != 0);
 
     std::vector<cv::Point2f> imageCVPoints;
     std::vector<cv::Point3f> worldCVPoints;
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "SolARPoseEstimationSACPnpOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 
@@ -44,6 +45,7 @@ SolARPoseEstimationSACPnpOpencv::SolARPoseEstimationSACPnpOpencv():ConfigurableB
     declareProperty("confidence", m_confidence);
     declareProperty("minNbInliers", m_NbInliersToValidPose);
     declareProperty("method", m_method);
+    declareProperty("profiling", m_profiling);
 
     m_camMatrix.create(3, 3, CV_32FC1);
     m_camDistorsion.create(5, 1, CV_32FC1);
@@ -60,9 +62,7 @@ FrameworkReturnCode SolARPoseEstimationSACPnpOpencv::estimate(const std::vector<
 															std::vector<uint32_t> & inliers,
                                                             Transform3Df & pose,
                                                             const Transform3Df initialPose) {
-
-    std::vector<cv::Point2f> imageCVPoints;
-    std::vector<cv::Point3f> worldCVPoints;
+    SolARScopedTimer timer("SolARPoseEstimationSACPnpOpencv::estimate", m_profiling != 0);
 
     int method;
     auto itr = convertPnPSACMethod.find(m_method);
@@ -78,12 +78,9 @@ FrameworkReturnCode SolARPoseEstimationSACPnpOpencv::estimate(const std::vector<
         return FrameworkReturnCode::_ERROR_  ; // vector of 2D and 3D points must have same size
     }
 
-    for (int i=0;i<imagePoints.size();++i) {
-        Point2Df point2D = imagePoints.at(i);
-        Point3Df point3D =worldPoints.at(i);
-        imageCVPoints.push_back(cv::Point2f(point2D.getX(), point2D.getY()));
-        worldCVPoints.push_back(cv::Point3f(point3D.getX(), point3D.getY(),point3D.getZ()));
-    }
+    // the points are given to OpenCV without copy
+    cv::Mat imageCVPoints = SolAROpenCVHelper::mapToOpenCV(imagePoints);
+    cv::Mat worldCVPoints = SolAROpenCVHelper::mapToOpenCV(worldPoints);
      cv::Mat Rvec;
      cv::Mat_<float> Tvec;
      cv::Mat raux, taux, r33;
@@ -111,12 +108,17 @@ FrameworkReturnCode SolARPoseEstimationSACPnpOpencv::estimate(const std::vector<
      cv::projectPoints(worldCVPoints, raux, taux, m_camMatrix, m_camDistorsion, projected3D);
 
 	 inliers.clear();
+     inliers.reserve(projected3D.size());
+     in2d.reserve(projected3D.size());
+     in3d.reserve(projected3D.size());
+     const cv::Point2f * imageCVPoint = imageCVPoints.ptr<cv::Point2f>();
+     const cv::Point3f * worldCVPoint = worldCVPoints.ptr<cv::Point3f>();
      for (int i = 0; i < projected3D.size(); i++) {
-		 double err_reprj = norm(projected3D[i] - imageCVPoints[i]);
+		 double err_reprj = norm(projected3D[i] - imageCVPoint[i]);
          if (err_reprj < m_reprojError) {
 			 inliers.push_back(i);
-             in2d.push_back(cv::Point2f(imagePoints[i].getX(),imagePoints[i].getY()));
-             in3d.push_back(cv::Point3f(worldPoints[i].getX(),worldPoints[i].getY(),worldPoints[i].getZ()));
+             in2d.push_back(imageCVPoint[i]);
+             in3d.push_back(worldCVPoint[i]);
          }
      }
 	 
@@ -16,6 +16,7 @@
 
 #include "SolARPoseFinderFrom2D2DOpencv.h"
 #include "SolAROpenCVHelper.h"
+#include "SolAREpipolarRANSAC.h"
 #include "core/Log.h"
 #include "opencv2/calib3d/calib3d.hpp"
 
@@ -86,7 +87,9 @@ FrameworkReturnCode SolARPoseFinderFrom2D2DOpencv::estimate(const std::vector<Po
 
     cv::minMaxIdx(points_view1, &minVal, &maxVal);
     cv::Point2f pp; pp.x=m_camCalibration(0,2); pp.y=m_camCalibration(1,2);
-    cv::Mat Ecv = cv::findEssentialMat(points_view1, points_view2, m_camCalibration(0,0), pp, cv::RANSAC, m_confidence, m_outlierDistanceRatio * maxVal, inliers);
+    cv::Mat Ecv = findEssentialMat(points_view1, points_view2, m_outlierDistanceRatio * maxVal, inliers);
+    if (Ecv.empty())
+        return FrameworkReturnCode::_ERROR_;
     cv::Mat cvRot;
     cv::Mat cvPos;
 
@@ -169,7 +172,9 @@ FrameworkReturnCode SolARPoseFinderFrom2D2DOpencv::estimate(const std::vector<Ke
     }
     cv::minMaxIdx(points_view1, &minVal, &maxVal);
     cv::Point2f pp; pp.x=m_camCalibration(0,2); pp.y=m_camCalibration(1,2);
-    cv::Mat Ecv = cv::findEssentialMat(points_view1, points_view2, m_camCalibration(0,0), pp, cv::RANSAC, m_confidence, m_outlierDistanceRatio * maxVal, inliers);
+    cv::Mat Ecv = findEssentialMat(points_view1, points_view2, m_outlierDistanceRatio * maxVal, inliers);
+    if (Ecv.empty())
+        return FrameworkReturnCode::_ERROR_;
     cv::Mat cvRot;
     cv::Mat cvPos;
 
@@ -206,6 +211,37 @@ FrameworkReturnCode SolARPoseFinderFrom2D2DOpencv::estimate(const std::vector<Ke
     return FrameworkReturnCode::_SUCCESS;
 }
 
+cv::Mat SolARPoseFinderFrom2D2DOpencv::findEssentialMat(const std::vector<cv::Point2f> & points_view1,
+                                                        const std::vector<cv::Point2f> & points_view2,
+                                                        float threshold,
+                                                        cv::Mat & inliers)
+{
+    // the essential matrix is estimated on points normalized with the camera intrinsics
+    float focal = m_camCalibration(0,0);
+    float cx = m_camCalibration(0,2);
+    float cy = m_camCalibration(1,2);
+    EpipolarCorrespondences correspondences;
+    correspondences.reserve(points_view1.size());
+    for (int i = 0; i < points_view1.size(); i++)
+        correspondences.push_back((points_view1[i].x - cx) / focal, (points_view1[i].y - cy) / focal,
+                                  (points_view2[i].x - cx) / focal, (points_view2[i].y - cy) / focal);
+
+    Eigen::Matrix3d E;
+    std::vector<uint8_t> status;
+    SolAREpipolarRANSAC ransac(SolAREpipolarRANSAC::Model::ESSENTIAL, threshold / focal, m_confidence);
+    if (!ransac.estimate(correspondences, E, status)) {
+        LOG_DEBUG("Essential matrix is empty");
+        inliers.release();
+        return cv::Mat();
+    }
+    inliers = cv::Mat(status, true);
+    cv::Mat Ecv(3, 3, CV_64F);
+    for (int row = 0; row < 3; row++)
+        for (int col = 0; col < 3; col++)
+            Ecv.at<double>(row, col) = E(row, col);
+    return Ecv;
+}
+
 void SolARPoseFinderFrom2D2DOpencv::setCameraParameters(const CamCalibration & intrinsicParams, const CamDistortion & distorsionParams) {
     m_camCalibration = intrinsicParams;
     m_camDistorsion = distorsionParams;
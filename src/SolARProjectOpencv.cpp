@@ -42,10 +42,8 @@ SolARProjectOpencv::~SolARProjectOpencv(){
 
 }
 
-FrameworkReturnCode projectCV(const std::vector<cv::Point3f> & inputPoints, std::vector<Point2Df> & imagePoints, const Transform3Df& pose, const cv::Mat & intrinsicParams, const cv::Mat & distorsionParams )
+FrameworkReturnCode projectCV(cv::InputArray inputPoints, std::vector<Point2Df> & imagePoints, const Transform3Df& pose, const cv::Mat & intrinsicParams, const cv::Mat & distorsionParams )
 {
-    std::vector<cv::Point2f> cvImagePoints;
-
     Transform3Df poseInv = pose.inverse();
 
     cv::Mat rotMat, rvec;
@@ -56,33 +54,29 @@ FrameworkReturnCode projectCV(const std::vector<cv::Point3f> & inputPoints, std:
     tvec.at<float>(2, 0) = poseInv(2, 3);
     cv::Rodrigues(rotMat, rvec);
 
+    // the projected points are written by OpenCV in the output vector
+    imagePoints.resize(inputPoints.total());
+    if (imagePoints.empty())
+        return FrameworkReturnCode::_SUCCESS;
+    cv::Mat cvImagePoints = SolAROpenCVHelper::mapToOpenCV(imagePoints);
     cv::projectPoints(inputPoints, rvec, tvec, intrinsicParams, distorsionParams, cvImagePoints);
 
-    imagePoints.clear();
-    for (auto cvPoint : cvImagePoints)
-        imagePoints.push_back(Point2Df((float)cvPoint.x, (float)cvPoint.y));
-
     return FrameworkReturnCode::_SUCCESS;
 }
 
 FrameworkReturnCode SolARProjectOpencv::project(const std::vector<Point3Df> & inputPoints, std::vector<Point2Df> & imagePoints, const Transform3Df& pose)
 {
-    std::vector<cv::Point3f> cvWorldPoints;
-
-    for (auto point : inputPoints)
-        cvWorldPoints.push_back(cv::Point3f(point.getX(), point.getY(), point.getZ()));
-
-      return projectCV(cvWorldPoints, imagePoints, pose, m_camMatrix, m_camDistorsion);
+    return projectCV(SolAROpenCVHelper::mapToOpenCV(inputPoints), imagePoints, pose, m_camMatrix, m_camDistorsion);
 }
 
 FrameworkReturnCode SolARProjectOpencv::project(const std::vector<SRef<CloudPoint>> & inputPoints, std::vector<Point2Df> & imagePoints, const Transform3Df& pose)
 {
-    std::vector<cv::Point3f> cvWorldPoints;
-
-    for (auto point : inputPoints)
-        cvWorldPoints.push_back(cv::Point3f(point->getX(), point->getY(), point->getZ()));
+    // the cloud points are shared, their coordinates are gathered in a buffer kept from one call to the next
+    m_worldPoints.resize(inputPoints.size());
+    for (size_t i = 0; i < inputPoints.size(); i++)
+        m_worldPoints[i] = cv::Point3f(inputPoints[i]->getX(), inputPoints[i]->getY(), inputPoints[i]->getZ());
 
-      return projectCV(cvWorldPoints, imagePoints, pose, m_camMatrix, m_camDistorsion);
+    return projectCV(m_worldPoints, imagePoints, pose, m_camMatrix, m_camDistorsion);
 }
 
 void SolARProjectOpencv::setCameraParameters(const CamCalibration & intrinsicParams, const CamDistortion & distorsionParams) {
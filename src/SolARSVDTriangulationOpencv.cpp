@@ -17,9 +17,11 @@
  */
 
 #include "SolARSVDTriangulationOpencv.h"
+#include "SolARLatencyProfiler.h"
 #include "SolAROpenCVHelper.h"
 #include "core/Log.h"
 #include "opencv2/calib3d/calib3d.hpp"
+#include <limits>
 
 namespace xpcf  = org::bcom::xpcf;
 
@@ -115,6 +117,8 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Point2Df> & po
                                                 const Transform3Df & poseView1,
                                                 const Transform3Df & poseView2,
                                                 std::vector<SRef<CloudPoint>> & pcloud){
+	// not configurable, recorded only when the profiler is enabled for the whole module
+	SolARScopedTimer timer("SolARSVDTriangulationOpencv::triangulate", false);
 	pcloud.clear();
 	Transform3Df poseView1Inverse = poseView1.inverse();
 	Transform3Df poseView2Inverse = poseView2.inverse();
@@ -129,6 +133,8 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Point2Df> & po
 	// Get position of keypoints
     unsigned int pts_size = static_cast<unsigned int>(matches.size());
 	std::vector<cv::Point2f> pts1, pts2;
+	pts1.reserve(pts_size);
+	pts2.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; ++i) {
 		Point2Df kp1 = pointsView1[matches[i].getIndexInDescriptorA()];
 		Point2Df kp2 = pointsView2[matches[i].getIndexInDescriptorB()];
@@ -138,14 +144,18 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Point2Df> & po
 
 	// Undistort keypoints
 	std::vector<cv::Point2f> ptsUn1, ptsUn2;
-	cv::undistortPoints(pts1, ptsUn1, m_camMatrix, m_camDistortion);
-	cv::undistortPoints(pts2, ptsUn2, m_camMatrix, m_camDistortion);
+	if (!m_undistortionGrid.undistort(pts1, ptsUn1) || !m_undistortionGrid.undistort(pts2, ptsUn2)) {
+		LOG_ERROR("The intrinsic parameters must be set before triangulating points");
+		pcloud.clear();
+		return std::numeric_limits<double>::max();
+	}
 
 	// Mean camera center to calculate view direction
 	Vector3f meanCamCenter((poseView1(0, 3) + poseView2(0, 3)) / 2, (poseView1(1, 3) + poseView2(1, 3)) / 2, (poseView1(2, 3) + poseView2(2, 3)) / 2);
 
 	// Triangulation
 	std::vector<Point3Df> pts3D;
+	pts3D.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; i++) {
 		cv::Point2f ptUn1 = ptsUn1[i];
 		cv::Point2f ptUn2 = ptsUn2[i];
@@ -162,6 +172,8 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Point2Df> & po
 
 	// Create cloud points
 	std::vector<float> reproj_error;
+	reproj_error.reserve(pts_size);
+	pcloud.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; ++i) {
 		// Compute reprojection error
 		cv::Point2f pt1 = pts1[i];
@@ -191,6 +203,7 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint> & ke
                                                 const Transform3Df & poseView1,
                                                 const Transform3Df & poseView2,
                                                 std::vector<SRef<CloudPoint>> & pcloud){
+	SolARScopedTimer timer("SolARSVDTriangulationOpencv::triangulate", false);
 	pcloud.clear();
 	Transform3Df poseView1Inverse = poseView1.inverse();
 	Transform3Df poseView2Inverse = poseView2.inverse();
@@ -205,6 +218,8 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint> & ke
 	// Get position of keypoints
     unsigned int pts_size = static_cast<unsigned int>(matches.size());
 	std::vector<cv::Point2f> pts1, pts2;
+	pts1.reserve(pts_size);
+	pts2.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; ++i) {
 		Keypoint kp1 = keypointsView1[matches[i].getIndexInDescriptorA()];
 		Keypoint kp2 = keypointsView2[matches[i].getIndexInDescriptorB()];
@@ -214,14 +229,18 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint> & ke
 
 	// Undistort keypoints
 	std::vector<cv::Point2f> ptsUn1, ptsUn2;
-	cv::undistortPoints(pts1, ptsUn1, m_camMatrix, m_camDistortion);
-	cv::undistortPoints(pts2, ptsUn2, m_camMatrix, m_camDistortion);
+	if (!m_undistortionGrid.undistort(pts1, ptsUn1) || !m_undistortionGrid.undistort(pts2, ptsUn2)) {
+		LOG_ERROR("The intrinsic parameters must be set before triangulating points");
+		pcloud.clear();
+		return std::numeric_limits<double>::max();
+	}
 
 	// Mean camera center to calculate view direction
 	Vector3f meanCamCenter((poseView1(0, 3) + poseView2(0, 3)) / 2, (poseView1(1, 3) + poseView2(1, 3)) / 2, (poseView1(2, 3) + poseView2(2, 3)) / 2);
 
 	// Triangulation
 	std::vector<Point3Df> pts3D;
+	pts3D.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; i++) {
 		cv::Point2f ptUn1 = ptsUn1[i];
 		cv::Point2f ptUn2 = ptsUn2[i];
@@ -238,6 +257,8 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint> & ke
 
 	// Create cloud points
 	std::vector<float> reproj_error;
+	reproj_error.reserve(pts_size);
+	pcloud.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; ++i) {
 		// Compute reprojection error
 		cv::Point2f pt1 = pts1[i];
@@ -270,6 +291,7 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint>& key
 												const Transform3Df & poseView2, 
 												std::vector<SRef<CloudPoint>>& pcloud)
 {
+	SolARScopedTimer timer("SolARSVDTriangulationOpencv::triangulate", false);
 	pcloud.clear();
 	Transform3Df poseView1Inverse = poseView1.inverse();
 	Transform3Df poseView2Inverse = poseView2.inverse();
@@ -284,6 +306,8 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint>& key
 	// Get position of keypoints
     unsigned int pts_size = static_cast<unsigned int>(matches.size());
 	std::vector<cv::Point2f> pts1, pts2;
+	pts1.reserve(pts_size);
+	pts2.reserve(pts_size);
 	for (unsigned int i = 0; i < pts_size; ++i) {
 		const Keypoint &kp1 = keypointsView1[matches[i].getIndexInDescriptorA()];
 		const Keypoint &kp2 = keypointsView2[matches[i].getIndexInDescriptorB()];
@@ -293,14 +317,18 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint>& key
 
 	// Undistort keypoints
 	std::vector<cv::Point2f> ptsUn1, ptsUn2;
-	cv::undistortPoints(pts1, ptsUn1, m_camMatrix, m_camDistortion);
-	cv::undistortPoints(pts2, ptsUn2, m_camMatrix, m_camDistortion);	
+	if (!m_undistortionGrid.undistort(pts1, ptsUn1) || !m_undistortionGrid.undistort(pts2, ptsUn2)) {
+		LOG_ERROR("The intrinsic parameters must be set before triangulating points");
+		pcloud.clear();
+		return std::numeric_limits<double>::max();
+	}
 
 	// Mean camera center to calculate view direction
 	Vector3f meanCamCenter((poseView1(0, 3) + poseView2(0, 3)) / 2, (poseView1(1, 3) + poseView2(1, 3)) / 2, (poseView1(2, 3) + poseView2(2, 3)) / 2);
 
 	// Triangulation
 	std::vector<Point3Df> pts3D;
+	pts3D.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; i++) {
 		cv::Point2f ptUn1 = ptsUn1[i];
 		cv::Point2f ptUn2 = ptsUn2[i];
@@ -317,6 +345,8 @@ double SolARSVDTriangulationOpencv::triangulate(const std::vector<Keypoint>& key
 
 	// Create cloud points
 	std::vector<float> reproj_error;
+	reproj_error.reserve(pts_size);
+	pcloud.reserve(pts_size);
     for (unsigned int i = 0; i < pts_size; ++i) {
 		// Compute reprojection error
 		cv::Point2f pt1 = pts1[i];
@@ -409,6 +439,7 @@ void SolARSVDTriangulationOpencv::setCameraParameters(const CamCalibration & int
     this->m_camMatrix.at<float>(2, 0) = intrinsicParams(2,0);
     this->m_camMatrix.at<float>(2, 1) = intrinsicParams(2,1);
     this->m_camMatrix.at<float>(2, 2) = intrinsicParams(2,2);
+    m_undistortionGrid.setCameraParameters(m_camMatrix, m_camDistortion);
 
 	m_projector->setCameraParameters(intrinsicParams, distortionParams);
 }
@@ -16,6 +16,7 @@
 
 #include "SolARUndistortPointsOpencv.h"
 #include "SolAROpenCVHelper.h"
+#include "core/Log.h"
 
 #include "opencv2/calib3d/calib3d.hpp"
 #include <opencv2/imgproc.hpp>
@@ -32,31 +33,30 @@ namespace OPENCV {
     {
         declareInterface<api::geom::IUndistortPoints>(this);
 
-        //internal data for matrix
-        m_camMatrix.create(3, 3, CV_32FC1);
-        m_camDistortion.create(5, 1, CV_32FC1);
+        //internal data for matrix, no distortion by default and no intrinsic parameters until they are set
+        m_camMatrix = cv::Mat::zeros(3, 3, CV_32FC1);
+        m_camDistortion = cv::Mat::zeros(5, 1, CV_32FC1);
 
     }
 
     FrameworkReturnCode SolARUndistortPointsOpencv::undistort(const std::vector<Point2Df> & inputPoints, std::vector<Point2Df> & outputPoints){
-        
-    std::vector<cv::Point2f> ptvec; 
-    std::vector<cv::Point2f> out_ptvec; 
 
-    ptvec.resize(inputPoints.size());
-    out_ptvec.resize(inputPoints.size());
-    outputPoints.resize(inputPoints.size());
-
-    for(unsigned int k = 0; k < inputPoints.size();k++){
-        ptvec[k].x = inputPoints[k].getX();
-        ptvec[k].y = inputPoints[k].getY();
-    }
-    
-      cv::undistortPoints(ptvec,out_ptvec, m_camMatrix, m_camDistortion);
-
-    for(unsigned int k = 0 ; k < out_ptvec.size() ; k++){
-        outputPoints[k] = Point2Df( out_ptvec[k].x, out_ptvec[k].y );
-    }
+        if (!m_undistortionGrid.isSet()) {
+            LOG_ERROR("The intrinsic parameters must be set before undistorting points");
+            return FrameworkReturnCode::_ERROR_;
+        }
+        m_points.resize(inputPoints.size());
+        for(unsigned int k = 0; k < inputPoints.size();k++){
+            m_points[k].x = inputPoints[k].getX();
+            m_points[k].y = inputPoints[k].getY();
+        }
+
+        m_undistortionGrid.undistort(m_points.data(), m_points.size(), m_points.data());
+
+        outputPoints.resize(inputPoints.size());
+        for(unsigned int k = 0 ; k < m_points.size() ; k++){
+            outputPoints[k] = Point2Df( m_points[k].x, m_points[k].y );
+        }
         return FrameworkReturnCode::_SUCCESS;
     }
 
@@ -72,6 +72,7 @@ namespace OPENCV {
         this->m_camMatrix.at<float>(2, 0) = m_intrinsic_parameters(2, 0);
         this->m_camMatrix.at<float>(2, 1) = m_intrinsic_parameters(2, 1);
         this->m_camMatrix.at<float>(2, 2) = m_intrinsic_parameters(2, 2);
+        m_undistortionGrid.setCameraParameters(m_camMatrix, m_camDistortion);
     }
 
     void SolARUndistortPointsOpencv::setDistortionParameters(const CamDistortion & distortion_parameters){
@@ -82,6 +83,7 @@ namespace OPENCV {
          this->m_camDistortion.at<float>(2, 0) = m_distortion_parameters(2);
          this->m_camDistortion.at<float>(3, 0) = m_distortion_parameters(3);
          this->m_camDistortion.at<float>(4, 0) = m_distortion_parameters(4);
+         m_undistortionGrid.setCameraParameters(m_camMatrix, m_camDistortion);
     }
 
     
@@ -0,0 +1,262 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SolARUndistortionGrid.h"
+#include "core/Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "opencv2/calib3d/calib3d.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+
+namespace SolAR {
+namespace MODULES {
+namespace OPENCV {
+
+namespace {
+
+// the extent of the grid is aligned on blocks of this size, in pixels
+const float GRID_ALIGNMENT = 64.f;
+
+// when the image size is unknown, the grid covers the queried points up to this distance from the optical axis, in normalized coordinates
+const float MAX_NORMALIZED_EXTENT = 2.f;
+
+#if CV_SIMD
+inline cv::v_float32 v_bilinear(const float * map, const cv::v_int32 & idx00, const cv::v_int32 & idx01,
+                                const cv::v_int32 & idx10, const cv::v_int32 & idx11,
+                                const cv::v_float32 & ax, const cv::v_float32 & ay)
+{
+    cv::v_float32 v00 = cv::v_lut(map, idx00);
+    cv::v_float32 v01 = cv::v_lut(map, idx01);
+    cv::v_float32 v10 = cv::v_lut(map, idx10);
+    cv::v_float32 v11 = cv::v_lut(map, idx11);
+    cv::v_float32 top = cv::v_fma(ax, v01 - v00, v00);
+    cv::v_float32 bottom = cv::v_fma(ax, v11 - v10, v10);
+    return cv::v_fma(ay, bottom - top, top);
+}
+#endif
+
+}
+
+SolARUndistortionGrid::SolARUndistortionGrid(float step) : m_step(step), m_invStep(1.f / step)
+{
+}
+
+void SolARUndistortionGrid::setCameraParameters(const cv::Mat & camMatrix, const cv::Mat & camDistortion, const cv::Size & imageSize)
+{
+    camMatrix.copyTo(m_camMatrix);
+    camDistortion.copyTo(m_camDistortion);
+    m_imageSize = imageSize;
+    // until the grid is rebuilt, no point is looked up in the grid of the previous parameters
+    m_valid = false;
+    m_cols = 0;
+    m_rows = 0;
+}
+
+bool SolARUndistortionGrid::isSet() const
+{
+    return !m_camMatrix.empty() && m_camMatrix.at<float>(0, 0) != 0.f && m_camMatrix.at<float>(1, 1) != 0.f;
+}
+
+bool SolARUndistortionGrid::undistort(const std::vector<cv::Point2f> & points, std::vector<cv::Point2f> & undistortedPoints)
+{
+    undistortedPoints.assign(points.size(), cv::Point2f());
+    return undistort(points.data(), points.size(), undistortedPoints.data());
+}
+
+bool SolARUndistortionGrid::undistort(const cv::Point2f * points, size_t count, cv::Point2f * undistortedPoints)
+{
+    if (!isSet()) {
+        LOG_ERROR("Points cannot be undistorted before the camera parameters are set");
+        return false;
+    }
+    if (count == 0)
+        return true;
+    update(points, count);
+    m_outside.clear();
+    size_t i = 0;
+#if CV_SIMD
+    const size_t nlanes = static_cast<size_t>(cv::v_float32::nlanes);
+    const float * src = reinterpret_cast<const float *>(points);
+    float * dst = reinterpret_cast<float *>(undistortedPoints);
+    const cv::v_float32 vOriginX = cv::vx_setall_f32(m_originX);
+    const cv::v_float32 vOriginY = cv::vx_setall_f32(m_originY);
+    const cv::v_float32 vInvStep = cv::vx_setall_f32(m_invStep);
+    const cv::v_float32 vZero = cv::vx_setzero_f32();
+    const cv::v_float32 vMaxX = cv::vx_setall_f32(static_cast<float>(m_cols - 1));
+    const cv::v_float32 vMaxY = cv::vx_setall_f32(static_cast<float>(m_rows - 1));
+    const cv::v_float32 vCols = cv::vx_setall_f32(static_cast<float>(m_cols));
+    const cv::v_int32 vOne = cv::vx_setall_s32(1);
+    const cv::v_int32 vBelow = cv::vx_setall_s32(m_cols);
+    const cv::v_int32 vBelowRight = cv::vx_setall_s32(m_cols + 1);
+    for (; i + nlanes <= count; i += nlanes) {
+        cv::v_float32 x, y;
+        cv::v_load_deinterleave(src + 2 * i, x, y);
+        cv::v_float32 gx = (x - vOriginX) * vInvStep;
+        cv::v_float32 gy = (y - vOriginY) * vInvStep;
+        if (!cv::v_check_all((gx >= vZero) & (gx < vMaxX) & (gy >= vZero) & (gy < vMaxY))) {
+            for (size_t k = i; k < i + nlanes; ++k)
+                if (!lookup(points[k].x, points[k].y, undistortedPoints[k]))
+                    m_outside.push_back(static_cast<int>(k));
+            continue;
+        }
+        cv::v_int32 ix = cv::v_floor(gx);
+        cv::v_int32 iy = cv::v_floor(gy);
+        cv::v_float32 ax = gx - cv::v_cvt_f32(ix);
+        cv::v_float32 ay = gy - cv::v_cvt_f32(iy);
+        cv::v_int32 idx00 = cv::v_round(cv::v_fma(cv::v_cvt_f32(iy), vCols, cv::v_cvt_f32(ix)));
+        cv::v_int32 idx01 = idx00 + vOne;
+        cv::v_int32 idx10 = idx00 + vBelow;
+        cv::v_int32 idx11 = idx00 + vBelowRight;
+        cv::v_float32 ux = v_bilinear(m_mapX.data(), idx00, idx01, idx10, idx11, ax, ay);
+        cv::v_float32 uy = v_bilinear(m_mapY.data(), idx00, idx01, idx10, idx11, ax, ay);
+        cv::v_store_interleave(dst + 2 * i, ux, uy);
+    }
+    cv::vx_cleanup();
+#endif
+    for (; i < count; ++i)
+        if (!lookup(points[i].x, points[i].y, undistortedPoints[i]))
+            m_outside.push_back(static_cast<int>(i));
+
+    // points far away from the image are solved iteratively
+    if (!m_outside.empty()) {
+        m_outsidePoints.resize(m_outside.size());
+        for (size_t k = 0; k < m_outside.size(); ++k)
+            m_outsidePoints[k] = points[m_outside[k]];
+        std::vector<cv::Point2f> outsideUndistorted;
+        cv::undistortPoints(m_outsidePoints, outsideUndistorted, m_camMatrix, m_camDistortion);
+        for (size_t k = 0; k < m_outside.size(); ++k)
+            undistortedPoints[m_outside[k]] = outsideUndistorted[k];
+    }
+    return true;
+}
+
+bool SolARUndistortionGrid::lookup(float x, float y, cv::Point2f & undistortedPoint) const
+{
+    float gx = (x - m_originX) * m_invStep;
+    float gy = (y - m_originY) * m_invStep;
+    if (!(gx >= 0.f && gx < m_cols - 1 && gy >= 0.f && gy < m_rows - 1))
+        return false;
+    int ix = static_cast<int>(gx);
+    int iy = static_cast<int>(gy);
+    float ax = gx - ix;
+    float ay = gy - iy;
+    const float * mapX = &m_mapX[iy * m_cols + ix];
+    const float * mapY = &m_mapY[iy * m_cols + ix];
+    float topX = mapX[0] + ax * (mapX[1] - mapX[0]);
+    float bottomX = mapX[m_cols] + ax * (mapX[m_cols + 1] - mapX[m_cols]);
+    float topY = mapY[0] + ax * (mapY[1] - mapY[0]);
+    float bottomY = mapY[m_cols] + ax * (mapY[m_cols + 1] - mapY[m_cols]);
+    undistortedPoint.x = topX + ay * (bottomX - topX);
+    undistortedPoint.y = topY + ay * (bottomY - topY);
+    return true;
+}
+
+void SolARUndistortionGrid::update(const cv::Point2f * points, size_t count)
+{
+    // the grid covers the image and may grow up to one image size around it, or up to a field of view around the optical axis
+    // when the image size is unknown, farther points are not worth a grid node
+    float windowMinX, windowMinY, windowMaxX, windowMaxY;
+    if (!m_imageSize.empty()) {
+        float width = static_cast<float>(m_imageSize.width);
+        float height = static_cast<float>(m_imageSize.height);
+        windowMinX = -width;
+        windowMinY = -height;
+        windowMaxX = 2.f * width;
+        windowMaxY = 2.f * height;
+    }
+    else {
+        float extentX = MAX_NORMALIZED_EXTENT * std::abs(m_camMatrix.at<float>(0, 0));
+        float extentY = MAX_NORMALIZED_EXTENT * std::abs(m_camMatrix.at<float>(1, 1));
+        windowMinX = m_camMatrix.at<float>(0, 2) - extentX;
+        windowMinY = m_camMatrix.at<float>(1, 2) - extentY;
+        windowMaxX = m_camMatrix.at<float>(0, 2) + extentX;
+        windowMaxY = m_camMatrix.at<float>(1, 2) + extentY;
+    }
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = std::numeric_limits<float>::lowest();
+    float maxY = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < count; ++i) {
+        const cv::Point2f & pt = points[i];
+        if (pt.x < windowMinX || pt.x > windowMaxX || pt.y < windowMinY || pt.y > windowMaxY)
+            continue;
+        minX = std::min(minX, pt.x);
+        minY = std::min(minY, pt.y);
+        maxX = std::max(maxX, pt.x);
+        maxY = std::max(maxY, pt.y);
+    }
+
+    float gridMinX = minX, gridMinY = minY, gridMaxX = maxX, gridMaxY = maxY;
+    if (m_valid) {
+        gridMinX = m_originX;
+        gridMinY = m_originY;
+        gridMaxX = m_originX + (m_cols - 1) * m_step;
+        gridMaxY = m_originY + (m_rows - 1) * m_step;
+        if (minX > maxX || (minX >= gridMinX && minY >= gridMinY && maxX < gridMaxX && maxY < gridMaxY))
+            return;
+    }
+    else if (!m_imageSize.empty()) {
+        gridMinX = 0.f;
+        gridMinY = 0.f;
+        gridMaxX = static_cast<float>(m_imageSize.width);
+        gridMaxY = static_cast<float>(m_imageSize.height);
+    }
+    else if (minX > maxX) {
+        // no point to cover yet, wait for the next call
+        return;
+    }
+    if (minX <= maxX) {
+        gridMinX = std::min(gridMinX, minX);
+        gridMinY = std::min(gridMinY, minY);
+        gridMaxX = std::max(gridMaxX, maxX);
+        gridMaxY = std::max(gridMaxY, maxY);
+    }
+    build(gridMinX, gridMinY, gridMaxX, gridMaxY);
+}
+
+void SolARUndistortionGrid::build(float minX, float minY, float maxX, float maxY)
+{
+    m_originX = std::floor(minX / GRID_ALIGNMENT) * GRID_ALIGNMENT;
+    m_originY = std::floor(minY / GRID_ALIGNMENT) * GRID_ALIGNMENT;
+    float endX = (std::floor(maxX / GRID_ALIGNMENT) + 1.f) * GRID_ALIGNMENT;
+    float endY = (std::floor(maxY / GRID_ALIGNMENT) + 1.f) * GRID_ALIGNMENT;
+    m_cols = static_cast<int>(std::ceil((endX - m_originX) * m_invStep)) + 1;
+    m_rows = static_cast<int>(std::ceil((endY - m_originY) * m_invStep)) + 1;
+
+    std::vector<cv::Point2f> nodes(static_cast<size_t>(m_cols) * m_rows);
+    for (int row = 0; row < m_rows; ++row)
+        for (int col = 0; col < m_cols; ++col)
+            nodes[row * m_cols + col] = cv::Point2f(m_originX + col * m_step, m_originY + row * m_step);
+    // the grid is built once, let the solver converge further than its default 5 iterations
+    std::vector<cv::Point2f> undistortedNodes;
+    cv::undistortPoints(nodes, undistortedNodes, m_camMatrix, m_camDistortion, cv::noArray(), cv::noArray(),
+                        cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 1e-8));
+    m_mapX.resize(nodes.size());
+    m_mapY.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        m_mapX[i] = undistortedNodes[i].x;
+        m_mapY[i] = undistortedNodes[i].y;
+    }
+    m_valid = true;
+    LOG_DEBUG("Undistortion grid of {}x{} nodes built from ({}, {})", m_cols, m_rows, m_originX, m_originY);
+}
+
+}
+}
+}
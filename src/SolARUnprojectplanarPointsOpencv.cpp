@@ -42,11 +42,14 @@ SolARUnprojectPlanarPointsOpencv::~SolARUnprojectPlanarPointsOpencv(){
 
 }
 
-FrameworkReturnCode unprojectOCV(const std::vector<cv::Point2f>& imagePoints, std::vector<Point3Df>& worldPoints, const Transform3Df& pose, const cv::Mat &m_camMatrix, const cv::Mat &m_camDistorsion)
+FrameworkReturnCode unprojectOCV(std::vector<cv::Point2f>& imagePoints, std::vector<Point3Df>& worldPoints, const Transform3Df& pose, SolARUndistortionGrid &undistortionGrid)
 {	
-	// undistort 2D points	
-	std::vector<cv::Point2f> correctedImagePoints;
-	cv::undistortPoints(imagePoints, correctedImagePoints, m_camMatrix, m_camDistorsion);
+	// undistort 2D points in place
+	if (!undistortionGrid.undistort(imagePoints.data(), imagePoints.size(), imagePoints.data())) {
+		LOG_ERROR("The intrinsic parameters must be set before unprojecting points");
+		return FrameworkReturnCode::_ERROR_;
+	}
+	const std::vector<cv::Point2f> & correctedImagePoints = imagePoints;
 
 	// get unproject transformation matrix
 	Transform3Df poseInv = pose.inverse();
@@ -72,11 +75,12 @@ FrameworkReturnCode SolARUnprojectPlanarPointsOpencv::unproject(const std::vecto
 {
     if (imagePoints.empty())
         return FrameworkReturnCode::_ERROR_;
-    std::vector<cv::Point2f> cvPoints;
-    for (auto point : imagePoints)
-        cvPoints.push_back(cv::Point2f(point.getX(), point.getY()));
+    m_points.clear();
+    m_points.reserve(imagePoints.size());
+    for (const auto & point : imagePoints)
+        m_points.push_back(cv::Point2f(point.getX(), point.getY()));
 
-    return unprojectOCV(cvPoints, worldPoints, pose, m_camMatrix, m_camDistorsion);
+    return unprojectOCV(m_points, worldPoints, pose, m_undistortionGrid);
 }
 
 FrameworkReturnCode SolARUnprojectPlanarPointsOpencv::unproject(const std::vector<Keypoint> & imageKeypoints,
@@ -85,11 +89,12 @@ FrameworkReturnCode SolARUnprojectPlanarPointsOpencv::unproject(const std::vecto
 {
     if (imageKeypoints.empty())
         return FrameworkReturnCode::_ERROR_;
-    std::vector<cv::Point2f> cvPoints;
-    for (auto point : imageKeypoints)
-        cvPoints.push_back(cv::Point2f(point.getX(), point.getY()));
+    m_points.clear();
+    m_points.reserve(imageKeypoints.size());
+    for (const auto & point : imageKeypoints)
+        m_points.push_back(cv::Point2f(point.getX(), point.getY()));
 
-    return unprojectOCV(cvPoints, worldPoints, pose, m_camMatrix, m_camDistorsion);
+    return unprojectOCV(m_points, worldPoints, pose, m_undistortionGrid);
 }
 
 void SolARUnprojectPlanarPointsOpencv::setCameraParameters(const CamCalibration & intrinsicParams, const CamDistortion & distorsionParams) {
@@ -109,6 +114,7 @@ void SolARUnprojectPlanarPointsOpencv::setCameraParameters(const CamCalibration
     this->m_camMatrix.at<float>(2, 0) = intrinsicParams(2,0);
     this->m_camMatrix.at<float>(2, 1) = intrinsicParams(2,1);
     this->m_camMatrix.at<float>(2, 2) = intrinsicParams(2,2);
+    m_undistortionGrid.setCameraParameters(m_camMatrix, m_camDistorsion);
 }
 
 }
@@ -0,0 +1,277 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "SolARVideoRecorderOpencv.h"
+#include "SolAROpenCVHelper.h"
+#include "core/Log.h"
+
+#include "opencv2/imgcodecs.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+namespace xpcf = org::bcom::xpcf;
+XPCF_DEFINE_FACTORY_CREATE_INSTANCE(SolAR::MODULES::OPENCV::SolARVideoRecorderOpencv)
+
+namespace SolAR {
+using namespace datastructure;
+namespace MODULES {
+namespace OPENCV {
+
+static const int FORMAT_VIDEO = 0;
+static const int FORMAT_PNG = 1;
+static const int FORMAT_RAW = 2;
+
+static std::map<std::string, int> convertFormat = {{"VIDEO", FORMAT_VIDEO},
+                                                   {"PNG", FORMAT_PNG},
+                                                   {"RAW", FORMAT_RAW}};
+
+static const int DROP_NEWEST = 0;
+static const int DROP_OLDEST = 1;
+static const int BLOCK = 2;
+
+static std::map<std::string, int> convertDropPolicy = {{"DROP_NEWEST", DROP_NEWEST},
+                                                       {"DROP_OLDEST", DROP_OLDEST},
+                                                       {"BLOCK", BLOCK}};
+
+SolARVideoRecorderOpencv::SolARVideoRecorderOpencv():ConfigurableBase(xpcf::toUUID<SolARVideoRecorderOpencv>())
+{
+    declareInterface<IImageRecorder>(this);
+    declareProperty("outputPath", m_outputPath);
+    declareProperty("format", m_format);
+    declareProperty("codec", m_codec);
+    declareProperty("frameRate", m_frameRate);
+    declareProperty("pngCompression", m_pngCompression);
+    declareProperty("queueSize", m_queueSize);
+    declareProperty("dropPolicy", m_dropPolicy);
+    LOG_DEBUG("SolARVideoRecorderOpencv constructor");
+}
+
+SolARVideoRecorderOpencv::~SolARVideoRecorderOpencv()
+{
+    close();
+    LOG_DEBUG("SolARVideoRecorderOpencv destructor");
+}
+
+FrameworkReturnCode SolARVideoRecorderOpencv::record(const SRef<Image> image, double timestamp)
+{
+    if (image == nullptr)
+    {
+        LOG_ERROR("The input image of SolARVideoRecorderOpencv is null");
+        return FrameworkReturnCode::_ERROR_;
+    }
+    if (m_failed)
+        return FrameworkReturnCode::_ERROR_;
+
+    // the format and the drop policy are fixed at the start of a recording
+    if (!m_worker.joinable())
+    {
+        auto format = convertFormat.find(m_format);
+        if (format == convertFormat.end())
+        {
+            LOG_WARNING("Video recorder format {} does not exist, VIDEO is used", m_format);
+            m_formatId = FORMAT_VIDEO;
+        }
+        else
+            m_formatId = format->second;
+        auto dropPolicy = convertDropPolicy.find(m_dropPolicy);
+        if (dropPolicy == convertDropPolicy.end())
+        {
+            LOG_WARNING("Video recorder drop policy {} does not exist, DROP_NEWEST is used", m_dropPolicy);
+            m_dropPolicyId = DROP_NEWEST;
+        }
+        else
+            m_dropPolicyId = dropPolicy->second;
+        m_nbImages = 0;
+        m_nbDropped = 0;
+        m_nbRecorded = 0;
+        m_worker = std::thread(&SolARVideoRecorderOpencv::writeLoop, this);
+    }
+
+    QueuedImage queued;
+    {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        size_t queueSize = static_cast<size_t>(std::max(m_queueSize, 1));
+        if (m_queue.size() >= queueSize)
+        {
+            if (m_dropPolicyId == BLOCK)
+                m_queueNotFull.wait(lock, [this, queueSize]() { return m_queue.size() < queueSize; });
+            else if (m_dropPolicyId == DROP_OLDEST)
+            {
+                m_freeImages.push_back(std::move(m_queue.front().image));
+                m_queue.pop_front();
+                m_nbDropped++;
+            }
+            else
+            {
+                m_nbDropped++;
+                return FrameworkReturnCode::_SUCCESS;
+            }
+        }
+        queued.index = m_nbImages++;
+        if (!m_freeImages.empty())
+        {
+            queued.image = std::move(m_freeImages.back());
+            m_freeImages.pop_back();
+        }
+    }
+
+    // the image is copied outside of the lock, into the buffer of an image already written
+    SolAROpenCVHelper::mapToOpenCV(image).copyTo(queued.image);
+    queued.timestamp = timestamp;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queue.push_back(std::move(queued));
+    }
+    m_queueNotEmpty.notify_one();
+    return FrameworkReturnCode::_SUCCESS;
+}
+
+FrameworkReturnCode SolARVideoRecorderOpencv::close()
+{
+    if (m_worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_stop = true;
+        }
+        m_queueNotEmpty.notify_one();
+        m_worker.join();
+        m_stop = false;
+        LOG_INFO("Recording {} closed: {} images written, {} dropped", m_outputPath, m_nbRecorded.load(), m_nbDropped.load());
+    }
+    return m_failed.exchange(false) ? FrameworkReturnCode::_ERROR_ : FrameworkReturnCode::_SUCCESS;
+}
+
+uint32_t SolARVideoRecorderOpencv::getQueueDepth() const
+{
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    return static_cast<uint32_t>(m_queue.size());
+}
+
+uint32_t SolARVideoRecorderOpencv::getNbDroppedImages() const
+{
+    return m_nbDropped;
+}
+
+uint32_t SolARVideoRecorderOpencv::getNbRecordedImages() const
+{
+    return m_nbRecorded;
+}
+
+void SolARVideoRecorderOpencv::writeLoop()
+{
+    for (;;)
+    {
+        QueuedImage queued;
+        {
+            // the queued images are written before stopping
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            m_queueNotEmpty.wait(lock, [this]() { return !m_queue.empty() || m_stop; });
+            if (m_queue.empty())
+                break;
+            queued = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_queueNotFull.notify_one();
+
+        // after a failure, the queue is still emptied so that a blocked caller is released
+        if (!m_failed)
+        {
+            if (write(queued))
+                m_nbRecorded++;
+            else
+                m_failed = true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_freeImages.push_back(std::move(queued.image));
+        }
+    }
+    m_writer.release();
+    if (m_timestamps.is_open())
+        m_timestamps.close();
+}
+
+bool SolARVideoRecorderOpencv::write(const QueuedImage & queued)
+{
+    const cv::Mat & image = queued.image;
+    if (!m_timestamps.is_open())
+    {
+        m_timestamps.open(m_outputPath + ".timestamps.txt");
+        if (!m_timestamps.is_open())
+        {
+            LOG_ERROR("Cannot open the timestamps file {}.timestamps.txt", m_outputPath);
+            return false;
+        }
+        m_timestamps << std::fixed << std::setprecision(3);
+    }
+
+    switch (m_formatId)
+    {
+    case FORMAT_VIDEO:
+        if (!m_writer.isOpened())
+        {
+            int fourcc = m_codec.size() == 4 ? cv::VideoWriter::fourcc(m_codec[0], m_codec[1], m_codec[2], m_codec[3])
+                                             : cv::VideoWriter::fourcc('M','J','P','G');
+            if (!m_writer.open(m_outputPath, fourcc, m_frameRate, image.size(), image.channels() != 1))
+            {
+                LOG_ERROR("Cannot open the video file {} with the codec {}", m_outputPath, m_codec);
+                return false;
+            }
+            m_videoSize = image.size();
+        }
+        if (image.size() != m_videoSize)
+        {
+            LOG_ERROR("The size of the images recorded into {} changed from {}x{} to {}x{}", m_outputPath,
+                      m_videoSize.width, m_videoSize.height, image.cols, image.rows);
+            return false;
+        }
+        m_writer.write(image);
+        break;
+    case FORMAT_PNG:
+    {
+        std::string path = m_outputPath + cv::format("_%06u.png", queued.index);
+        if (!cv::imwrite(path, image, {cv::IMWRITE_PNG_COMPRESSION, m_pngCompression}))
+        {
+            LOG_ERROR("Cannot write the image {}", path);
+            return false;
+        }
+        break;
+    }
+    case FORMAT_RAW:
+    {
+        // the queued images are continuous
+        std::string path = m_outputPath + cv::format("_%06u_%dx%dx%d.raw", queued.index, image.cols, image.rows, image.channels());
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char *>(image.data), static_cast<std::streamsize>(image.total() * image.elemSize()));
+        if (!file)
+        {
+            LOG_ERROR("Cannot write the image {}", path);
+            return false;
+        }
+        break;
+    }
+    }
+    m_timestamps << queued.index << " " << queued.timestamp << "\n";
+    return true;
+}
+
+}
+}
+}  // end of namespace Solar
@@ -0,0 +1,122 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCHMARKFIXTURES_H
+#define BENCHMARKFIXTURES_H
+
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "opencv2/core.hpp"
+#include "opencv2/imgproc.hpp"
+#include "datastructure/Image.h"
+#include "SolAROpenCVHelper.h"
+
+// Synthetic inputs and timing helpers shared by the benchmarks and the micro-benchmarks
+
+// Build a synthetic global map of nbPoints points with 32 bytes binary descriptors, and a local map
+// sharing half of them (slightly moved, with a few flipped descriptor bits) plus as many new points
+inline void createSyntheticMaps(int nbPoints, cv::Mat& points, cv::Mat& descriptors, cv::Mat& globalPoints, cv::Mat& globalDescriptors)
+{
+    cv::RNG rng(42);
+    // keep a constant density of points whatever the size of the map
+    float side = std::cbrt(static_cast<float>(nbPoints)) * 0.5f;
+    globalPoints.create(nbPoints, 3, CV_32F);
+    rng.fill(globalPoints, cv::RNG::UNIFORM, 0.f, side);
+    globalDescriptors.create(nbPoints, 32, CV_8U);
+    rng.fill(globalDescriptors, cv::RNG::UNIFORM, 0, 256);
+
+    int nbLocalPoints = nbPoints / 2;
+    points.create(nbLocalPoints, 3, CV_32F);
+    descriptors.create(nbLocalPoints, 32, CV_8U);
+    for (int i = 0; i < nbLocalPoints; ++i) {
+        if (i % 2 == 0) {
+            int idx = rng.uniform(0, nbPoints);
+            for (int k = 0; k < 3; ++k)
+                points.at<float>(i, k) = globalPoints.at<float>(idx, k) + rng.uniform(-0.02f, 0.02f);
+            globalDescriptors.row(idx).copyTo(descriptors.row(i));
+            for (int b = 0; b < 4; ++b)
+                descriptors.at<uchar>(i, rng.uniform(0, 32)) ^= static_cast<uchar>(1 << rng.uniform(0, 8));
+        }
+        else {
+            for (int k = 0; k < 3; ++k)
+                points.at<float>(i, k) = rng.uniform(0.f, side);
+            rng.fill(descriptors.row(i), cv::RNG::UNIFORM, 0, 256);
+        }
+    }
+}
+
+template <class F>
+inline double measureMs(F func)
+{
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Render a 1080p grey frame cluttered with random shapes, with a 5x5 squared binary marker in its middle
+inline void createMarkerFrame(cv::Mat& frame)
+{
+    cv::RNG rng(42);
+    frame.create(1080, 1920, CV_8U);
+    frame.setTo(255);
+    for (int i = 0; i < 300; ++i) {
+        cv::Point center(rng.uniform(0, frame.cols), rng.uniform(0, frame.rows));
+        cv::Scalar color(rng.uniform(0, 200));
+        if (i % 2 == 0)
+            cv::rectangle(frame, cv::Rect(center, cv::Size(rng.uniform(5, 60), rng.uniform(5, 60))), color, cv::FILLED);
+        else
+            cv::circle(frame, center, rng.uniform(3, 30), color, cv::FILLED);
+    }
+    const int cellSize = 40;
+    cv::Rect marker(820, 400, 7 * cellSize, 7 * cellSize);
+    cv::rectangle(frame, marker + cv::Size(cellSize, cellSize) - cv::Point(cellSize / 2, cellSize / 2), cv::Scalar(255), cv::FILLED);
+    cv::rectangle(frame, marker, cv::Scalar(0), cv::FILLED);
+    for (int y = 1; y < 6; ++y)
+        for (int x = 1; x < 6; ++x)
+            if (rng.uniform(0, 2))
+                cv::rectangle(frame, cv::Rect(marker.x + x * cellSize, marker.y + y * cellSize, cellSize, cellSize), cv::Scalar(255), cv::FILLED);
+}
+
+// Render the marker frame smoothed as by a camera, at another resolution if needed
+inline void createBlurredMarkerFrame(cv::Size size, cv::Mat& frame)
+{
+    cv::Mat frame1080;
+    createMarkerFrame(frame1080);
+    cv::GaussianBlur(frame1080, frame1080, cv::Size(5, 5), 0);
+    if (size == frame1080.size())
+        frame = frame1080;
+    else
+        cv::resize(frame1080, frame, size, 0, 0, cv::INTER_AREA);
+}
+
+// Create a BGR or grey video of the blurred marker frame translated by a few pixels from one frame to the next
+inline void createMarkerVideo(int nbFrames, std::vector<SRef<SolAR::datastructure::Image>> & video, cv::Size size = cv::Size(1920, 1080), bool color = true)
+{
+    cv::Mat frame, movedFrame;
+    createBlurredMarkerFrame(size, frame);
+    if (color)
+        cv::cvtColor(frame, frame, cv::COLOR_GRAY2BGR);
+    video.resize(nbFrames);
+    for (int i = 0; i < nbFrames; ++i) {
+        cv::Mat translation = (cv::Mat_<double>(2, 3) << 1., 0., 2. * i, 0., 1., 1. * i);
+        cv::warpAffine(frame, movedFrame, translation, frame.size(), cv::INTER_LINEAR, cv::BORDER_REPLICATE);
+        SolAR::MODULES::OPENCV::SolAROpenCVHelper::convertToSolar(movedFrame, video[i]);
+    }
+}
+
+#endif // BENCHMARKFIXTURES_H
@@ -0,0 +1,481 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "opencv2/core.hpp"
+#include "opencv2/calib3d.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+#include "xpcf/xpcf.h"
+#include "SolARKeypointDetectorOpencv.h"
+#include "SolARDescriptorsExtractorORBOpencv.h"
+#include "SolARDescriptorsExtractorAKAZEOpencv.h"
+#include "SolARDescriptorsExtractorAKAZE2Opencv.h"
+#include "SolARDescriptorsExtractorSIFTOpencv.h"
+#include "SolARDescriptorMatcherKNNOpencv.h"
+#include "SolARDescriptorMatcherHammingBruteForceOpencv.h"
+#include "SolARDescriptorMatcherRadiusOpencv.h"
+#include "SolAROpticalFlowPyrLKOpencv.h"
+#include "SolARPoseEstimationSACPnpOpencv.h"
+#include "SolARPoseEstimationPnpOpencv.h"
+#include "SolARSVDTriangulationOpencv.h"
+#include "SolARProjectOpencv.h"
+#include "SolARMapFusionOpencv.h"
+#include "SolARFiducialMarkerDetectorOpencv.h"
+#include "SolARLatencyProfiler.h"
+#include "SolAROpenCVHelper.h"
+#include "BenchmarkFixtures.h"
+#include "MicroBenchmarks.h"
+
+using namespace SolAR;
+using namespace SolAR::datastructure;
+using namespace SolAR::MODULES::OPENCV;
+namespace xpcf = org::bcom::xpcf;
+
+namespace {
+
+// every benchmark runs at least MIN_ITERATIONS times and until minTime seconds are spent, after a warm-up call
+const int MIN_ITERATIONS = 3;
+const int MAX_ITERATIONS = 100000;
+
+struct Result
+{
+    std::string name;
+    int iterations = 0;
+    double meanMs = 0.;
+    double medianMs = 0.;
+    double minMs = 0.;
+    double stddevMs = 0.;
+    // figures of the last iteration, to check that the measured work does not change from one run to the next
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+// Runs the benchmarks whose name contains the filter and gathers their results in the order they are run
+class Runner
+{
+public:
+    Runner(const std::string & filter, double minTime) : m_filter(filter), m_minTime(minTime) {}
+
+    template <class F>
+    Result * run(const std::string & name, F func)
+    {
+        if (name.find(m_filter) == std::string::npos)
+            return nullptr;
+        std::cerr << name << std::endl;
+        func();
+        std::vector<double> times;
+        double totalMs = 0.;
+        while ((totalMs < m_minTime * 1000. || times.size() < static_cast<size_t>(MIN_ITERATIONS)) && times.size() < static_cast<size_t>(MAX_ITERATIONS)) {
+            auto start = std::chrono::steady_clock::now();
+            func();
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            totalMs += times.back();
+        }
+        Result result;
+        result.name = name;
+        result.iterations = static_cast<int>(times.size());
+        result.meanMs = totalMs / times.size();
+        for (double time : times)
+            result.stddevMs += (time - result.meanMs) * (time - result.meanMs);
+        result.stddevMs = std::sqrt(result.stddevMs / times.size());
+        std::sort(times.begin(), times.end());
+        result.minMs = times.front();
+        result.medianMs = times[times.size() / 2];
+        m_results.push_back(result);
+        return &m_results.back();
+    }
+
+    double getMinTime() const { return m_minTime; }
+
+    // the benchmarks in the order they are run, then the latencies recorded by the instrumented components sorted by name
+    std::string toJSON() const
+    {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(4);
+        json << "{\n  \"context\": {\"opencv_version\": \"" << CV_VERSION << "\", \"num_threads\": " << cv::getNumThreads()
+             << ", \"min_time_s\": " << m_minTime << "},\n  \"benchmarks\": [";
+        for (size_t i = 0; i < m_results.size(); ++i) {
+            const Result & result = m_results[i];
+            json << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+                 << ", \"mean_ms\": " << result.meanMs << ", \"median_ms\": " << result.medianMs
+                 << ", \"min_ms\": " << result.minMs << ", \"stddev_ms\": " << result.stddevMs << ", \"counters\": {";
+            for (size_t j = 0; j < result.counters.size(); ++j)
+                json << (j == 0 ? "" : ", ") << "\"" << result.counters[j].first << "\": " << result.counters[j].second;
+            json << "}}";
+        }
+        json << (m_results.empty() ? "],\n" : "\n  ],\n") << "  \"components\": " << SolARLatencyProfiler::toJSON() << "\n}\n";
+        return json.str();
+    }
+
+private:
+    std::string m_filter;
+    double m_minTime;
+    std::vector<Result> m_results;
+};
+
+struct Input
+{
+    std::string name;
+    SRef<Image> image;
+};
+
+// The bundled images of a scene seen from two view points, and the synthetic frame at two scales
+bool loadInputs(const std::string & dataDir, std::vector<Input> & inputs, SRef<Image> & secondView)
+{
+    cv::Mat graf1 = cv::imread(dataDir + "/graf1.png", cv::IMREAD_COLOR);
+    cv::Mat graf3 = cv::imread(dataDir + "/graf3.png", cv::IMREAD_COLOR);
+    if (graf1.empty() || graf3.empty()) {
+        std::cerr << "Cannot load " << dataDir << "/graf1.png and " << dataDir << "/graf3.png, set the data directory with --data=" << std::endl;
+        return false;
+    }
+    inputs.resize(3);
+    inputs[0].name = "graf1";
+    SolAROpenCVHelper::convertToSolar(graf1, inputs[0].image);
+    SolAROpenCVHelper::convertToSolar(graf3, secondView);
+    const std::vector<std::pair<std::string, cv::Size>> sizes = {{"synthetic_vga", cv::Size(640, 480)}, {"synthetic_1080p", cv::Size(1920, 1080)}};
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        cv::Mat frame;
+        createBlurredMarkerFrame(sizes[i].second, frame);
+        inputs[i + 1].name = sizes[i].first;
+        SolAROpenCVHelper::convertToSolar(frame, inputs[i + 1].image);
+    }
+    return true;
+}
+
+using KeypointDetectorType = api::features::IKeypointDetector::KeypointDetectorType;
+
+const std::vector<std::pair<std::string, KeypointDetectorType>> featureTypes = {
+    {"ORB", KeypointDetectorType::ORB}, {"AKAZE", KeypointDetectorType::AKAZE},
+    {"AKAZE2", KeypointDetectorType::AKAZE2}, {"SIFT", KeypointDetectorType::SIFT}};
+
+SRef<api::features::IKeypointDetector> createDetector(KeypointDetectorType type)
+{
+    auto detector = xpcf::ComponentFactory::createInstance<SolARKeypointDetectorOpencv>()->bindTo<api::features::IKeypointDetector>();
+    detector->bindTo<xpcf::IConfigurable>()->getProperty("nbDescriptors")->setIntegerValue(1000);
+    detector->setType(type);
+    return detector;
+}
+
+SRef<api::features::IDescriptorsExtractor> createExtractor(const std::string & type)
+{
+    if (type == "ORB")
+        return xpcf::ComponentFactory::createInstance<SolARDescriptorsExtractorORBOpencv>()->bindTo<api::features::IDescriptorsExtractor>();
+    if (type == "AKAZE")
+        return xpcf::ComponentFactory::createInstance<SolARDescriptorsExtractorAKAZEOpencv>()->bindTo<api::features::IDescriptorsExtractor>();
+    if (type == "AKAZE2")
+        return xpcf::ComponentFactory::createInstance<SolARDescriptorsExtractorAKAZE2Opencv>()->bindTo<api::features::IDescriptorsExtractor>();
+    return xpcf::ComponentFactory::createInstance<SolARDescriptorsExtractorSIFTOpencv>()->bindTo<api::features::IDescriptorsExtractor>();
+}
+
+void benchmarkFeatures(Runner & runner, const std::vector<Input> & inputs)
+{
+    for (const auto & featureType : featureTypes) {
+        const std::string & type = featureType.first;
+        auto detector = createDetector(featureType.second);
+        auto extractor = createExtractor(type);
+        for (const auto & input : inputs) {
+            std::vector<Keypoint> keypoints;
+            if (Result * result = runner.run("detection/" + type + "/" + input.name, [&]() { detector->detect(input.image, keypoints); }))
+                result->counters.emplace_back("keypoints", keypoints.size());
+            detector->detect(input.image, keypoints);
+            SRef<DescriptorBuffer> descriptors;
+            if (Result * result = runner.run("extraction/" + type + "/" + input.name, [&]() { extractor->extract(input.image, keypoints, descriptors); }))
+                result->counters.emplace_back("descriptors", descriptors->getNbDescriptors());
+        }
+    }
+}
+
+// One buffer per descriptor, as the descriptors of the points of a map projected in a frame
+void splitDescriptors(const SRef<DescriptorBuffer> & descriptors, std::vector<SRef<DescriptorBuffer>> & split)
+{
+    size_t size = descriptors->getNbElements() * CV_ELEM_SIZE(SolAROpenCVHelper::deduceOpenDescriptorCVType(descriptors->getDescriptorDataType()));
+    split.resize(descriptors->getNbDescriptors());
+    for (size_t i = 0; i < split.size(); ++i) {
+        split[i] = xpcf::utils::make_shared<DescriptorBuffer>(descriptors->getDescriptorType(), descriptors->getDescriptorDataType(),
+                                                              descriptors->getNbElements(), 1);
+        std::memcpy(split[i]->data(), static_cast<const unsigned char *>(descriptors->data()) + i * size, size);
+    }
+}
+
+void benchmarkMatchers(Runner & runner, const Input & firstView, const SRef<Image> & secondView)
+{
+    // binary descriptors for the Hamming matcher, float descriptors for the others
+    for (const auto & featureType : {featureTypes[0], featureTypes[3]}) {
+        const std::string & type = featureType.first;
+        auto detector = createDetector(featureType.second);
+        auto extractor = createExtractor(type);
+        std::vector<Keypoint> keypoints1, keypoints2;
+        SRef<DescriptorBuffer> descriptors1, descriptors2;
+        detector->detect(firstView.image, keypoints1);
+        detector->detect(secondView, keypoints2);
+        extractor->extract(firstView.image, keypoints1, descriptors1);
+        extractor->extract(secondView, keypoints2, descriptors2);
+        std::vector<SRef<DescriptorBuffer>> descriptorsList = {descriptors2, descriptors1};
+
+        std::vector<std::pair<std::string, SRef<api::features::IDescriptorMatcher>>> matchers;
+        if (type == "ORB") {
+            matchers.emplace_back("HammingBruteForce", xpcf::ComponentFactory::createInstance<SolARDescriptorMatcherHammingBruteForceOpencv>()->bindTo<api::features::IDescriptorMatcher>());
+        }
+        else {
+            matchers.emplace_back("KNN", xpcf::ComponentFactory::createInstance<SolARDescriptorMatcherKNNOpencv>()->bindTo<api::features::IDescriptorMatcher>());
+            auto radius = xpcf::ComponentFactory::createInstance<SolARDescriptorMatcherRadiusOpencv>()->bindTo<api::features::IDescriptorMatcher>();
+            radius->bindTo<xpcf::IConfigurable>()->getProperty("maxDistance")->setFloatingValue(200.f);
+            matchers.emplace_back("Radius", radius);
+        }
+        for (const auto & matcher : matchers) {
+            std::vector<DescriptorMatch> matches;
+            std::string name = "matching/" + matcher.first + "/" + type + "/" + firstView.name;
+            if (Result * result = runner.run(name, [&]() { matcher.second->match(descriptors1, descriptors2, matches); }))
+                result->counters.emplace_back("matches", matches.size());
+            if (Result * result = runner.run(name + "/list", [&]() { matcher.second->match(descriptors1, descriptorsList, matches); }))
+                result->counters.emplace_back("matches", matches.size());
+        }
+
+        // the keypoints of the first view matched to the keypoints of the second view around their position
+        if (type == "SIFT") {
+            auto matcher = xpcf::ComponentFactory::createInstance<SolARDescriptorMatcherKNNOpencv>()->bindTo<api::features::IDescriptorMatcher>();
+            std::vector<Point2Df> points;
+            for (const auto & keypoint : keypoints1)
+                points.push_back(Point2Df(keypoint.getX(), keypoint.getY()));
+            std::vector<SRef<DescriptorBuffer>> pointDescriptors;
+            splitDescriptors(descriptors1, pointDescriptors);
+            SRef<Frame> frame = xpcf::utils::make_shared<Frame>(keypoints2, descriptors2, secondView);
+            std::vector<DescriptorMatch> matches;
+            if (Result * result = runner.run("matching/KNN/matchInRegion/" + type + "/" + firstView.name,
+                                             [&]() { matcher->matchInRegion(points, pointDescriptors, frame, matches, 100.f, 0.f); }))
+                result->counters.emplace_back("matches", matches.size());
+        }
+    }
+}
+
+void benchmarkOpticalFlow(Runner & runner)
+{
+    const std::vector<std::pair<std::string, cv::Size>> sizes = {{"synthetic_vga", cv::Size(640, 480)}, {"synthetic_1080p", cv::Size(1920, 1080)}};
+    for (const auto & size : sizes) {
+        const int nbFrames = 10;
+        std::vector<SRef<Image>> video;
+        createMarkerVideo(nbFrames, video, size.second, false);
+        std::vector<cv::Point2f> corners;
+        cv::goodFeaturesToTrack(SolAROpenCVHelper::mapToOpenCV(video[0]), corners, 1000, 0.01, 5);
+        std::vector<Point2Df> points;
+        for (const auto & corner : corners)
+            points.push_back(Point2Df(corner.x, corner.y));
+
+        auto opticalFlow = xpcf::ComponentFactory::createInstance<SolAROpticalFlowPyrLKOpencv>()->bindTo<api::tracking::IOpticalFlowEstimator>();
+        std::vector<Point2Df> trackedPoints;
+        std::vector<unsigned char> status;
+        std::vector<float> error;
+        int frameIndex = 0;
+        // consecutive pairs of frames, as in a tracking loop
+        if (Result * result = runner.run("optical_flow/PyrLK/" + size.first, [&]() {
+                opticalFlow->estimate(video[frameIndex], video[frameIndex + 1], points, trackedPoints, status, error);
+                frameIndex = (frameIndex + 1) % (nbFrames - 1);
+            }))
+            result->counters.emplace_back("tracked_points", static_cast<double>(std::count(status.begin(), status.end(), 1)));
+    }
+}
+
+// A VGA camera looking at points spread in front of it, and a second camera moved 20 cm to its right and slightly rotated
+struct SyntheticScene
+{
+    CamCalibration calibration;
+    CamDistortion distortion;
+    Transform3Df pose1;
+    Transform3Df pose2;
+    std::vector<Point3Df> points;
+};
+
+void createSyntheticScene(int nbPoints, SyntheticScene & scene)
+{
+    scene.calibration << 500.f, 0.f, 320.f,
+                         0.f, 500.f, 240.f,
+                         0.f, 0.f, 1.f;
+    scene.distortion = CamDistortion::Zero();
+    scene.pose1 = Transform3Df::Identity();
+    scene.pose2 = Transform3Df::Identity();
+    cv::Mat rotation;
+    cv::Rodrigues(cv::Vec3d(0.02, -0.05, 0.01), rotation);
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            scene.pose2(i, j) = static_cast<float>(rotation.at<double>(i, j));
+    scene.pose2(0, 3) = 0.2f;
+    cv::RNG rng(42);
+    scene.points.clear();
+    for (int i = 0; i < nbPoints; ++i) {
+        float z = rng.uniform(2.f, 6.f);
+        scene.points.push_back(Point3Df(rng.uniform(-0.6f, 0.6f) * z, rng.uniform(-0.45f, 0.45f) * z, z));
+    }
+}
+
+void benchmarkGeometry(Runner & runner)
+{
+    SyntheticScene scene;
+    createSyntheticScene(1000, scene);
+    auto projector = xpcf::ComponentFactory::createInstance<SolARProjectOpencv>()->bindTo<api::geom::IProject>();
+    projector->setCameraParameters(scene.calibration, scene.distortion);
+
+    for (int nbPoints : {1000, 100000}) {
+        SyntheticScene projected;
+        createSyntheticScene(nbPoints, projected);
+        std::vector<Point2Df> imagePoints;
+        if (Result * result = runner.run("projection/" + std::to_string(nbPoints), [&]() { projector->project(projected.points, imagePoints, projected.pose2); }))
+            result->counters.emplace_back("points", imagePoints.size());
+    }
+
+    // the observations of the second camera, with one pixel of noise and 30% of outliers
+    std::vector<Point2Df> points1, points2;
+    projector->project(scene.points, points1, scene.pose1);
+    projector->project(scene.points, points2, scene.pose2);
+    cv::RNG rng(7);
+    std::vector<Point2Df> observations;
+    for (size_t i = 0; i < points2.size(); ++i) {
+        if (i % 10 < 3)
+            observations.push_back(Point2Df(rng.uniform(0.f, 640.f), rng.uniform(0.f, 480.f)));
+        else
+            observations.push_back(Point2Df(points2[i].getX() + rng.uniform(-1.f, 1.f), points2[i].getY() + rng.uniform(-1.f, 1.f)));
+    }
+
+    auto sacPnp = xpcf::ComponentFactory::createInstance<SolARPoseEstimationSACPnpOpencv>()->bindTo<api::solver::pose::I3DTransformSACFinderFrom2D3D>();
+    sacPnp->setCameraParameters(scene.calibration, scene.distortion);
+    std::vector<uint32_t> inliers;
+    Transform3Df pose;
+    if (Result * result = runner.run("pose/SACPnp/1000", [&]() { sacPnp->estimate(observations, scene.points, inliers, pose); }))
+        result->counters.emplace_back("inliers", inliers.size());
+
+    std::vector<Point2Df> inlierObservations;
+    std::vector<Point3Df> inlierPoints;
+    for (uint32_t index : inliers) {
+        inlierObservations.push_back(observations[index]);
+        inlierPoints.push_back(scene.points[index]);
+    }
+    auto pnp = xpcf::ComponentFactory::createInstance<SolARPoseEstimationPnpOpencv>()->bindTo<api::solver::pose::I3DTransformFinderFrom2D3D>();
+    pnp->setCameraParameters(scene.calibration, scene.distortion);
+    if (Result * result = runner.run("pose/Pnp/" + std::to_string(inlierPoints.size()), [&]() { pnp->estimate(inlierObservations, inlierPoints, pose); }))
+        result->counters.emplace_back("points", inlierPoints.size());
+
+    // the triangulator projects the points with an injected projector
+    auto triangulator = xpcf::ComponentFactory::createInstance<SolARSVDTriangulationOpencv>();
+    triangulator->bindTo<xpcf::IInjectable>()->inject<api::geom::IProject>(
+                xpcf::ComponentFactory::createInstance<SolARProjectOpencv>()->bindTo<api::geom::IProject>());
+    auto triangulatorInterface = triangulator->bindTo<api::solver::map::ITriangulator>();
+    triangulatorInterface->setCameraParameters(scene.calibration, scene.distortion);
+    std::vector<DescriptorMatch> matches;
+    for (size_t i = 0; i < points1.size(); ++i)
+        matches.push_back(DescriptorMatch(static_cast<int>(i), static_cast<int>(i), 0.f));
+    std::vector<SRef<CloudPoint>> cloud;
+    double reprojectionError = 0.;
+    if (Result * result = runner.run("triangulation/SVD/1000", [&]() {
+            reprojectionError = triangulatorInterface->triangulate(points1, points2, matches, std::make_pair(0u, 1u), scene.pose1, scene.pose2, cloud);
+        })) {
+        result->counters.emplace_back("points", cloud.size());
+        result->counters.emplace_back("reprojection_error", reprojectionError);
+    }
+}
+
+void benchmarkMapFusion(Runner & runner)
+{
+    for (int nbPoints : {10000, 100000}) {
+        cv::Mat points, descriptors, globalPoints, globalDescriptors;
+        createSyntheticMaps(nbPoints, points, descriptors, globalPoints, globalDescriptors);
+        std::vector<std::pair<uint32_t, uint32_t>> duplicates;
+        if (Result * result = runner.run("map_fusion/findDuplicates/" + std::to_string(nbPoints), [&]() {
+                SolARMapFusionOpencv::findDuplicates(points, descriptors, globalPoints, globalDescriptors, 0.3f, 0.75f, duplicates);
+            }))
+            result->counters.emplace_back("duplicates", duplicates.size());
+    }
+}
+
+void benchmarkMarkerPipeline(Runner & runner, const std::vector<Input> & inputs)
+{
+    for (const auto & input : inputs) {
+        if (input.name.find("synthetic") != 0)
+            continue;
+        for (int tracking : {0, 1}) {
+            auto detector = xpcf::ComponentFactory::createInstance<SolARFiducialMarkerDetectorOpencv>()->bindTo<IFiducialMarkerDetector>();
+            detector->bindTo<xpcf::IConfigurable>()->getProperty("tracking")->setIntegerValue(tracking);
+            SRef<DescriptorBuffer> descriptors;
+            std::vector<Contour2Df> contours;
+            if (Result * result = runner.run(std::string("marker/") + (tracking ? "tracking/" : "full_frame/") + input.name,
+                                             [&]() { detector->detect(input.image, descriptors, contours); }))
+                result->counters.emplace_back("markers", contours.size() / 4);
+        }
+    }
+}
+
+}
+
+int runMicroBenchmarks(int argc, char **argv)
+{
+    // the measures are written as JSON on the standard output or in a file, the progress on the error output
+    std::string filter, outputFile, dataDir = "../../data";
+    double minTime = 0.5;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.find("--benchmark_filter=") == 0)
+            filter = arg.substr(std::strlen("--benchmark_filter="));
+        else if (arg.find("--benchmark_out=") == 0)
+            outputFile = arg.substr(std::strlen("--benchmark_out="));
+        else if (arg.find("--benchmark_min_time=") == 0)
+            minTime = std::stod(arg.substr(std::strlen("--benchmark_min_time=")));
+        else if (arg.find("--data=") == 0)
+            dataDir = arg.substr(std::strlen("--data="));
+        else {
+            std::cerr << "Usage: " << argv[0] << " --micro [--benchmark_filter=<substring>] [--benchmark_out=<file.json>]"
+                      << " [--benchmark_min_time=<seconds>] [--data=<tests data directory>]" << std::endl;
+            return -1;
+        }
+    }
+
+    std::vector<Input> inputs;
+    SRef<Image> secondView;
+    if (!loadInputs(dataDir, inputs, secondView))
+        return -1;
+
+    // the components report their own latencies next to the measures of the benchmarks
+    SolARLatencyProfiler::setEnabled(true);
+    Runner runner(filter, minTime);
+    benchmarkFeatures(runner, inputs);
+    benchmarkMatchers(runner, inputs[0], secondView);
+    benchmarkOpticalFlow(runner);
+    benchmarkGeometry(runner);
+    benchmarkMapFusion(runner);
+    benchmarkMarkerPipeline(runner, inputs);
+
+    std::string json = runner.toJSON();
+    if (outputFile.empty()) {
+        std::cout << json;
+    }
+    else {
+        std::ofstream output(outputFile);
+        if (!output) {
+            std::cerr << "Cannot write " << outputFile << std::endl;
+            return -1;
+        }
+        output << json;
+    }
+    return 0;
+}
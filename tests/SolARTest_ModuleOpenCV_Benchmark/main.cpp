@@ -0,0 +1,657 @@
+/**
+ * @copyright Copyright (c) 2017 B-com http://www.b-com.com/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "opencv2/core.hpp"
+#include "opencv2/calib3d.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+#include "opencv2/video/tracking.hpp"
+#include "opencv2/videoio.hpp"
+#include "xpcf/xpcf.h"
+#include "core/Log.h"
+#include "SolARMapFusionOpencv.h"
+#include "SolARUndistortionGrid.h"
+#include "SolARFiducialMarkerDetectorOpencv.h"
+#include "SolARContoursFilterBinaryMarkerOpencv.h"
+#include "SolARPerspectiveControllerOpencv.h"
+#include "SolARImageFilterAdaptiveBinaryOpencv.h"
+#include "SolARImageFilterBlurOpencv.h"
+#include "SolARImageFilterBinaryOpencv.h"
+#include "SolARImageFilterErodeOpencv.h"
+#include "SolARImageFilterDilateOpencv.h"
+#include "SolARImageFilterChainOpencv.h"
+#include "SolARFastGaussian.h"
+#include "SolARKeypointDetectorRegionOpencv.h"
+#include "SolAROpticalFlowPyrLKOpencv.h"
+#include "SolARDenseOpticalFlowOpencv.h"
+#include "SolARMatchesOverlayOpencv.h"
+#include "SolARImageViewerOpencv.h"
+#include "SolARVideoRecorderOpencv.h"
+#include "SolAROpenCVHelper.h"
+#include "BenchmarkFixtures.h"
+#include "MicroBenchmarks.h"
+
+using namespace SolAR;
+using namespace SolAR::datastructure;
+using namespace SolAR::MODULES::OPENCV;
+namespace xpcf = org::bcom::xpcf;
+
+namespace {
+
+void benchmarkMapFusionDuplicates()
+{
+    for (int nbPoints : {10000, 100000, 1000000}) {
+        cv::Mat points, descriptors, globalPoints, globalDescriptors;
+        createSyntheticMaps(nbPoints, points, descriptors, globalPoints, globalDescriptors);
+        std::vector<std::pair<uint32_t, uint32_t>> duplicatesSingle, duplicatesParallel;
+        int nbThreads = cv::getNumThreads();
+        cv::setNumThreads(1);
+        double timeSingle = measureMs([&]() {
+            SolARMapFusionOpencv::findDuplicates(points, descriptors, globalPoints, globalDescriptors, 0.3f, 0.75f, duplicatesSingle);
+        });
+        cv::setNumThreads(nbThreads);
+        double timeParallel = measureMs([&]() {
+            SolARMapFusionOpencv::findDuplicates(points, descriptors, globalPoints, globalDescriptors, 0.3f, 0.75f, duplicatesParallel);
+        });
+        // the randomized kd-trees of the timed runs give approximate neighbors, the determinism is checked with an exact search
+        std::vector<std::pair<uint32_t, uint32_t>> exactSingle, exactParallel;
+        cv::setNumThreads(1);
+        SolARMapFusionOpencv::findDuplicates(points, descriptors, globalPoints, globalDescriptors, 0.3f, 0.75f, exactSingle, true);
+        cv::setNumThreads(nbThreads);
+        SolARMapFusionOpencv::findDuplicates(points, descriptors, globalPoints, globalDescriptors, 0.3f, 0.75f, exactParallel, true);
+        LOG_INFO("MapFusion findDuplicates {} points: {} duplicates, 1 thread {} ms, {} threads {} ms, identical: {}",
+                 nbPoints, duplicatesParallel.size(), timeSingle, nbThreads, timeParallel, exactSingle == exactParallel);
+    }
+}
+
+void benchmarkUndistortion()
+{
+    // VGA cameras with a strong radial distortion, the second one with a principal point far from the image center
+    for (const cv::Point2f & principalPoint : {cv::Point2f(320.f, 240.f), cv::Point2f(120.f, 400.f)}) {
+        cv::Mat camMatrix = (cv::Mat_<float>(3, 3) << 500.f, 0.f, principalPoint.x, 0.f, 500.f, principalPoint.y, 0.f, 0.f, 1.f);
+        cv::Mat camDistortion = (cv::Mat_<float>(5, 1) << -0.3f, 0.1f, 0.001f, -0.001f, 0.f);
+        cv::RNG rng(42);
+        const int nbPoints = 100000;
+        std::vector<cv::Point2f> points(nbPoints);
+        for (auto & pt : points)
+            pt = cv::Point2f(rng.uniform(0.f, 640.f), rng.uniform(0.f, 480.f));
+
+        std::vector<cv::Point2f> reference, iterative, lookup, lookupWithSize;
+        cv::undistortPoints(points, reference, camMatrix, camDistortion, cv::noArray(), cv::noArray(),
+                            cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 100, 1e-10));
+        double timeIterative = measureMs([&]() {
+            cv::undistortPoints(points, iterative, camMatrix, camDistortion);
+        });
+        SolARUndistortionGrid grid;
+        grid.setCameraParameters(camMatrix, camDistortion);
+        double timeBuild = measureMs([&]() {
+            grid.undistort(points, lookup);
+        });
+        double timeLookup = measureMs([&]() {
+            grid.undistort(points, lookup);
+        });
+        SolARUndistortionGrid gridWithSize;
+        gridWithSize.setCameraParameters(camMatrix, camDistortion, cv::Size(640, 480));
+        gridWithSize.undistort(points, lookupWithSize);
+
+        // errors are expressed in pixels
+        auto maxError = [&](const std::vector<cv::Point2f> & undistorted) {
+            double error = 0.;
+            for (int i = 0; i < nbPoints; ++i)
+                error = std::max(error, cv::norm(undistorted[i] - reference[i]) * camMatrix.at<float>(0, 0));
+            return error;
+        };
+        LOG_INFO("Undistortion {} points, principal point ({}, {}): iterative solver {} ms (max error {} px), lookup grid {} ms (max error {} px, {} px with the image size), first call with grid build {} ms",
+                 nbPoints, principalPoint.x, principalPoint.y, timeIterative, maxError(iterative), timeLookup, maxError(lookup), maxError(lookupWithSize), timeBuild);
+        if (std::max(maxError(lookup), maxError(lookupWithSize)) > 0.05)
+            LOG_ERROR("The lookup grid differs from cv::undistortPoints by more than 0.05 px");
+    }
+}
+
+void benchmarkMarkerTracking()
+{
+    cv::Mat frame;
+    createMarkerFrame(frame);
+    SRef<Image> image;
+    SolAROpenCVHelper::convertToSolar(frame, image);
+
+    const int nbFrames = 100;
+    for (int tracking : {0, 1}) {
+        auto detector = xpcf::ComponentFactory::createInstance<SolARFiducialMarkerDetectorOpencv>()->bindTo<IFiducialMarkerDetector>();
+        detector->bindTo<xpcf::IConfigurable>()->getProperty("tracking")->setIntegerValue(tracking);
+        SRef<DescriptorBuffer> descriptors;
+        std::vector<Contour2Df> contours;
+        detector->detect(image, descriptors, contours);
+        double time = measureMs([&]() {
+            for (int i = 0; i < nbFrames; ++i)
+                detector->detect(image, descriptors, contours);
+        });
+        LOG_INFO("Fiducial marker detection 1080p {}: {} markers, {} ms per frame",
+                 tracking ? "with tracking" : "full frame", contours.size() / 4, time / nbFrames);
+    }
+}
+
+// Reference pairwise suppression of the quadrilaterals whose corners are too close, as done before the grid of centroids
+void removeTooNearCandidatesPairwise(const std::vector<Contour2Df>& candidates, float minDistance, std::vector<Contour2Df>& filtered)
+{
+    auto perimeter = [](const Contour2Df & quad) {
+        float sum = 0.f;
+        for (size_t i = 0; i < quad.size(); ++i)
+            sum += (quad[i] - quad[(i + 1) % quad.size()]).norm();
+        return sum;
+    };
+    std::vector<bool> removalMask(candidates.size(), false);
+    for (size_t i = 0; i < candidates.size(); ++i)
+        for (size_t j = i + 1; j < candidates.size(); ++j) {
+            float distSquared = 0.f;
+            for (int c = 0; c < 4; ++c) {
+                Point2Df v = candidates[i][c] - candidates[j][c];
+                distSquared += v.dot(v);
+            }
+            if (distSquared / 4 < minDistance * minDistance)
+                removalMask[perimeter(candidates[i]) > perimeter(candidates[j]) ? j : i] = true;
+        }
+    filtered.clear();
+    for (size_t i = 0; i < candidates.size(); ++i)
+        if (!removalMask[i])
+            filtered.push_back(candidates[i]);
+}
+
+void benchmarkContoursFilter()
+{
+    // 1k quadrilaterals spread over a 1080p frame, two thirds of them are jittered copies of another one
+    cv::RNG rng(42);
+    const int nbQuads = 1000;
+    std::vector<Contour2Df> candidates;
+    for (int i = 0; i < nbQuads; ++i) {
+        if (i % 3 != 0) {
+            Contour2Df quad = candidates[rng.uniform(0, static_cast<int>(candidates.size()))];
+            for (auto & corner : quad)
+                corner = Point2Df(corner.getX() + rng.uniform(-8.f, 8.f), corner.getY() + rng.uniform(-8.f, 8.f));
+            candidates.push_back(quad);
+        }
+        else {
+            float x = rng.uniform(0.f, 1920.f), y = rng.uniform(0.f, 1080.f), size = rng.uniform(20.f, 80.f);
+            candidates.push_back({Point2Df(x, y), Point2Df(x + size, y), Point2Df(x + size, y + size), Point2Df(x, y + size)});
+        }
+    }
+
+    const int nbRuns = 100;
+    std::vector<Contour2Df> pairwise, grid;
+    double timePairwise = measureMs([&]() {
+        for (int i = 0; i < nbRuns; ++i)
+            removeTooNearCandidatesPairwise(candidates, 10.f, pairwise);
+    });
+    double timeGrid = measureMs([&]() {
+        for (int i = 0; i < nbRuns; ++i)
+            SolARContoursFilterBinaryMarkerOpencv::removeTooNearCandidates(candidates, 10.f, grid);
+    });
+    bool identical = pairwise.size() == grid.size();
+    for (size_t i = 0; identical && i < grid.size(); ++i)
+        for (int c = 0; c < 4; ++c)
+            identical = identical && pairwise[i][c] == grid[i][c];
+    LOG_INFO("Contours filter too near candidates {} quads: {} kept, pairwise {} ms, grid of centroids {} ms, identical: {}",
+             nbQuads, grid.size(), timePairwise / nbRuns, timeGrid / nbRuns, identical);
+}
+
+void benchmarkPerspectiveController()
+{
+    cv::Mat frame;
+    createMarkerFrame(frame);
+    SRef<Image> image;
+    SolAROpenCVHelper::convertToSolar(frame, image);
+
+    // 500 small quadrilaterals rectified to 56x56 patches, the size of a 5x5 marker with 8 pixels cells
+    cv::RNG rng(42);
+    const int nbContours = 500;
+    std::vector<Contour2Df> contours;
+    for (int i = 0; i < nbContours; ++i) {
+        float x = rng.uniform(0.f, 1800.f), y = rng.uniform(0.f, 960.f), size = rng.uniform(30.f, 120.f);
+        contours.push_back({Point2Df(x, y), Point2Df(x + size, y + rng.uniform(-5.f, 5.f)),
+                            Point2Df(x + size, y + size), Point2Df(x + rng.uniform(-5.f, 5.f), y + size)});
+    }
+
+    // the strip mode is not part of the interface
+    auto controller = xpcf::utils::make_shared<SolARPerspectiveControllerOpencv>();
+    auto configurable = controller->bindTo<xpcf::IConfigurable>();
+    configurable->getProperty("outputImageWidth")->setIntegerValue(56);
+    configurable->getProperty("outputImageHeight")->setIntegerValue(56);
+
+    const int nbRuns = 20;
+    for (const std::string interpolation : {"LINEAR", "NEAREST"}) {
+        configurable->getProperty("interpolation")->setStringValue(interpolation.c_str());
+        controller->onConfigured();
+        std::vector<SRef<Image>> patches;
+        SRef<Image> strip;
+        // first calls allocate the outputs
+        controller->correct(image, contours, patches);
+        controller->correct(image, contours, strip);
+        int nbThreads = cv::getNumThreads();
+        cv::setNumThreads(1);
+        double timeSingle = measureMs([&]() {
+            for (int i = 0; i < nbRuns; ++i)
+                controller->correct(image, contours, patches);
+        });
+        cv::setNumThreads(nbThreads);
+        double timePatches = measureMs([&]() {
+            for (int i = 0; i < nbRuns; ++i)
+                controller->correct(image, contours, patches);
+        });
+        double timeStrip = measureMs([&]() {
+            for (int i = 0; i < nbRuns; ++i)
+                controller->correct(image, contours, strip);
+        });
+        LOG_INFO("Perspective controller {} contours {}: reused patches 1 thread {} ms, {} threads {} ms, strip {} ms",
+                 nbContours, interpolation, timeSingle / nbRuns, nbThreads, timePatches / nbRuns, timeStrip / nbRuns);
+    }
+}
+
+void benchmarkAdaptiveThreshold()
+{
+    cv::Mat frame1080;
+    createMarkerFrame(frame1080);
+    const int nbFrames = 50;
+    for (cv::Size size : {cv::Size(1280, 720), cv::Size(1920, 1080)}) {
+        cv::Mat frame;
+        cv::resize(frame1080, frame, size, 0, 0, cv::INTER_AREA);
+        cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
+        SRef<Image> image;
+        SolAROpenCVHelper::convertToSolar(frame, image);
+
+        cv::Mat reference;
+        double timeOpencv = measureMs([&]() {
+            for (int i = 0; i < nbFrames; ++i)
+                cv::adaptiveThreshold(frame, reference, 255, cv::ADAPTIVE_THRESH_MEAN_C, cv::THRESH_BINARY, 11, 2);
+        });
+        for (int meanScale : {1, 2}) {
+            auto binaryFilter = xpcf::ComponentFactory::createInstance<SolARImageFilterAdaptiveBinaryOpencv>()->bindTo<api::image::IImageFilter>();
+            binaryFilter->bindTo<xpcf::IConfigurable>()->getProperty("meanScale")->setIntegerValue(meanScale);
+            SRef<Image> binary;
+            binaryFilter->filter(image, binary);
+            double time = measureMs([&]() {
+                for (int i = 0; i < nbFrames; ++i)
+                    binaryFilter->filter(image, binary);
+            });
+            double differentPixels = cv::countNonZero(reference != SolAROpenCVHelper::mapToOpenCV(binary)) * 100. / reference.total();
+            LOG_INFO("Adaptive threshold {}x{} meanScale {}: cv::adaptiveThreshold {} ms, fused {} ms per frame, {}% different pixels",
+                     size.width, size.height, meanScale, timeOpencv / nbFrames, time / nbFrames, differentPixels);
+        }
+    }
+}
+
+// Create an image filter component and set its integer properties
+template <class T>
+SRef<api::image::IImageFilter> createImageFilter(const std::vector<std::pair<const char *, int>> & properties)
+{
+    auto imageFilter = xpcf::ComponentFactory::createInstance<T>()->template bindTo<api::image::IImageFilter>();
+    auto configurable = imageFilter->template bindTo<xpcf::IConfigurable>();
+    for (const auto & property : properties)
+        configurable->getProperty(property.first)->setIntegerValue(property.second);
+    return imageFilter;
+}
+
+void benchmarkImageFilterChain()
+{
+    cv::Mat frame;
+    createMarkerFrame(frame);
+    cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
+    SRef<Image> image;
+    SolAROpenCVHelper::convertToSolar(frame, image);
+
+    auto blur = createImageFilter<SolARImageFilterBlurOpencv>({{"kernel_id", 0}, {"kernel_width", 3}, {"kernel_height", 3}, {"direction", 0}});
+    auto binary = createImageFilter<SolARImageFilterBinaryOpencv>({{"min", 128}, {"max", 255}});
+    auto erode = createImageFilter<SolARImageFilterErodeOpencv>({{"erosion_elem", 0}, {"erosion_size", 1}});
+    auto dilate = createImageFilter<SolARImageFilterDilateOpencv>({{"dilate_elem", 0}, {"dilate_size", 1}});
+    auto chain = createImageFilter<SolARImageFilterChainOpencv>({{"kernel_width", 3}, {"kernel_height", 3}, {"min", 128}, {"max", 255},
+                                                                 {"erosion_elem", 0}, {"erosion_size", 1}, {"dilate_elem", 0}, {"dilate_size", 1}});
+
+    const int nbFrames = 50;
+    SRef<Image> blurred, binarized, eroded, dilated, fused;
+    auto runSequence = [&]() {
+        blur->filter(image, blurred);
+        binary->filter(blurred, binarized);
+        erode->filter(binarized, eroded);
+        dilate->filter(eroded, dilated);
+    };
+    // first calls allocate the outputs, the next ones reuse them
+    runSequence();
+    chain->filter(image, fused);
+    double timeSequence = measureMs([&]() {
+        for (int i = 0; i < nbFrames; ++i)
+            runSequence();
+    });
+    double timeChain = measureMs([&]() {
+        for (int i = 0; i < nbFrames; ++i)
+            chain->filter(image, fused);
+    });
+    bool identical = cv::countNonZero(SolAROpenCVHelper::mapToOpenCV(dilated) != SolAROpenCVHelper::mapToOpenCV(fused)) == 0;
+    LOG_INFO("Blur, binary, erode and dilate filters 1080p: sequence {} ms, fused chain {} ms per frame, identical: {}",
+             timeSequence / nbFrames, timeChain / nbFrames, identical);
+}
+
+void benchmarkFastGaussian()
+{
+    cv::Mat frame8U, frame32F;
+    createMarkerFrame(frame8U);
+    frame8U.convertTo(frame32F, CV_32F, 1. / 255.);
+    const int nbFrames = 20;
+    for (const cv::Mat & frame : {frame8U, frame32F}) {
+        const char * type = frame.depth() == CV_8U ? "8U" : "32F";
+        double scale = frame.depth() == CV_8U ? 1. : 255.;
+        for (int sigma = 1; sigma <= 8; ++sigma) {
+            cv::Mat reference, fast;
+            double timeGaussian = measureMs([&]() {
+                for (int i = 0; i < nbFrames; ++i)
+                    cv::GaussianBlur(frame, reference, cv::Size(0, 0), sigma);
+            });
+            double timeFast = measureMs([&]() {
+                for (int i = 0; i < nbFrames; ++i)
+                    SolARFastGaussian::blur(frame, fast, cv::Size(0, 0), static_cast<float>(sigma));
+            });
+            // errors in grey levels, the 32F frame is in [0, 1]
+            cv::Mat error;
+            cv::absdiff(reference, fast, error);
+            error.convertTo(error, CV_32F, scale);
+            double maxError;
+            cv::minMaxLoc(error, nullptr, &maxError);
+            LOG_INFO("Gaussian blur {} sigma {}: cv::GaussianBlur {} ms, fast Gaussian {} ms per frame, error max {} mean {}",
+                     type, sigma, timeGaussian / nbFrames, timeFast / nbFrames, maxError, cv::mean(error)[0]);
+        }
+    }
+}
+
+void benchmarkKeypointDetectorRegion()
+{
+    cv::Mat frame;
+    createMarkerFrame(frame);
+    SRef<Image> image;
+    SolAROpenCVHelper::convertToSolar(frame, image);
+
+    // the whole frame, a quarter of it and a tilted quad around the marker
+    std::vector<std::vector<Point2Df>> regions = {
+        {Point2Df(0.f, 0.f), Point2Df(1919.f, 0.f), Point2Df(1919.f, 1079.f), Point2Df(0.f, 1079.f)},
+        {Point2Df(480.f, 270.f), Point2Df(1440.f, 270.f), Point2Df(1440.f, 810.f), Point2Df(480.f, 810.f)},
+        {Point2Df(790.f, 390.f), Point2Df(1120.f, 370.f), Point2Df(1140.f, 700.f), Point2Df(800.f, 720.f)}};
+    const int nbFrames = 10;
+    auto detector = xpcf::ComponentFactory::createInstance<SolARKeypointDetectorRegionOpencv>()->bindTo<api::features::IKeypointDetectorRegion>();
+    for (const auto & region : regions) {
+        std::vector<Keypoint> keypoints;
+        detector->detect(image, region, keypoints);
+        double time = measureMs([&]() {
+            for (int i = 0; i < nbFrames; ++i)
+                detector->detect(image, region, keypoints);
+        });
+        std::vector<cv::Point2f> polygon;
+        for (const auto & corner : region)
+            polygon.push_back(cv::Point2f(corner.getX(), corner.getY()));
+        cv::Rect box = cv::boundingRect(polygon);
+        LOG_INFO("Keypoint detection in a region of {}x{} pixels: {} keypoints, {} ms per frame",
+                 box.width, box.height, keypoints.size(), time / nbFrames);
+    }
+}
+
+void benchmarkOpticalFlow()
+{
+    const int nbFrames = 30;
+    std::vector<SRef<Image>> video;
+    createMarkerVideo(nbFrames, video);
+    cv::Mat grey;
+    cv::cvtColor(SolAROpenCVHelper::mapToOpenCV(video[0]), grey, cv::COLOR_BGR2GRAY);
+    std::vector<cv::Point2f> corners;
+    cv::goodFeaturesToTrack(grey, corners, 1000, 0.01, 5);
+    std::vector<Point2Df> points;
+    for (const auto & corner : corners)
+        points.push_back(Point2Df(corner.x, corner.y));
+
+    // the same points are tracked between each pair of consecutive frames
+    std::vector<std::vector<cv::Point2f>> referencePoints(nbFrames);
+    double timeImages = measureMs([&]() {
+        cv::Mat previousGrey, currentGrey;
+        std::vector<unsigned char> status;
+        std::vector<float> error;
+        for (int i = 1; i < nbFrames; ++i) {
+            cv::cvtColor(SolAROpenCVHelper::mapToOpenCV(video[i - 1]), previousGrey, cv::COLOR_BGR2GRAY);
+            cv::cvtColor(SolAROpenCVHelper::mapToOpenCV(video[i]), currentGrey, cv::COLOR_BGR2GRAY);
+            cv::calcOpticalFlowPyrLK(previousGrey, currentGrey, corners, referencePoints[i], status, error, cv::Size(21, 21), 3,
+                                     cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 0.03f));
+        }
+    });
+    auto opticalFlow = xpcf::ComponentFactory::createInstance<SolAROpticalFlowPyrLKOpencv>()->bindTo<api::tracking::IOpticalFlowEstimator>();
+    std::vector<std::vector<Point2Df>> trackedPoints(nbFrames);
+    double timeComponent = measureMs([&]() {
+        std::vector<unsigned char> status;
+        std::vector<float> error;
+        for (int i = 1; i < nbFrames; ++i)
+            opticalFlow->estimate(video[i - 1], video[i], points, trackedPoints[i], status, error);
+    });
+    float maxDifference = 0.f;
+    for (int i = 1; i < nbFrames; ++i)
+        for (size_t j = 0; j < corners.size(); ++j)
+            maxDifference = std::max(maxDifference, std::max(std::abs(trackedPoints[i][j].getX() - referencePoints[i][j].x),
+                                                             std::abs(trackedPoints[i][j].getY() - referencePoints[i][j].y)));
+    LOG_INFO("Optical flow 1080p BGR {} points: images {} ms, cached pyramids {} ms per frame, max difference {} pixels",
+             corners.size(), timeImages / (nbFrames - 1), timeComponent / (nbFrames - 1), maxDifference);
+
+    // forward tracking followed by a backward call and an outlier pass, against the built-in forward-backward mode
+    int nbInliers = 0;
+    double timeBackwardCall = measureMs([&]() {
+        std::vector<unsigned char> status, backwardStatus;
+        std::vector<float> error, backwardError;
+        std::vector<Point2Df> backwardPoints;
+        for (int i = 1; i < nbFrames; ++i) {
+            opticalFlow->estimate(video[i - 1], video[i], points, trackedPoints[i], status, error);
+            opticalFlow->estimate(video[i], video[i - 1], trackedPoints[i], backwardPoints, backwardStatus, backwardError);
+            nbInliers = 0;
+            for (size_t j = 0; j < points.size(); ++j) {
+                Point2Df drift = backwardPoints[j] - points[j];
+                if (status[j] && backwardStatus[j] && drift.dot(drift) <= 1.f)
+                    nbInliers++;
+            }
+        }
+    });
+    auto forwardBackwardFlow = xpcf::ComponentFactory::createInstance<SolAROpticalFlowPyrLKOpencv>()->bindTo<api::tracking::IOpticalFlowEstimator>();
+    forwardBackwardFlow->bindTo<xpcf::IConfigurable>()->getProperty("forwardBackward")->setIntegerValue(1);
+    int nbForwardBackwardInliers = 0;
+    double timeForwardBackward = measureMs([&]() {
+        std::vector<unsigned char> status;
+        std::vector<float> error;
+        for (int i = 1; i < nbFrames; ++i) {
+            forwardBackwardFlow->estimate(video[i - 1], video[i], points, trackedPoints[i], status, error);
+            nbForwardBackwardInliers = static_cast<int>(std::count(status.begin(), status.end(), 1));
+        }
+    });
+    LOG_INFO("Forward-backward optical flow 1080p BGR {} points: backward call {} ms ({} inliers), forward-backward mode {} ms ({} inliers) per frame",
+             corners.size(), timeBackwardCall / (nbFrames - 1), nbInliers, timeForwardBackward / (nbFrames - 1), nbForwardBackwardInliers);
+}
+
+void benchmarkDenseOpticalFlow()
+{
+    const int nbFrames = 30;
+    std::vector<SRef<Image>> video;
+    createMarkerVideo(nbFrames, video);
+    // QVGA frames, every fifth one blurred by a horizontal motion
+    std::vector<SRef<Image>> qvgaVideo(nbFrames);
+    cv::Mat frame, motionKernel = cv::Mat::ones(1, 9, CV_32F) / 9.f;
+    for (int i = 0; i < nbFrames; ++i) {
+        cv::resize(SolAROpenCVHelper::mapToOpenCV(video[i]), frame, cv::Size(320, 240), 0, 0, cv::INTER_AREA);
+        if (i % 5 == 4)
+            cv::filter2D(frame, frame, -1, motionKernel);
+        SolAROpenCVHelper::convertToSolar(frame, qvgaVideo[i]);
+    }
+
+    auto motionEstimator = xpcf::ComponentFactory::createInstance<SolARDenseOpticalFlowOpencv>()->bindTo<IFrameMotionEstimator>();
+    std::vector<float> medianFlows(nbFrames), blurScores(nbFrames);
+    int nbThreads = cv::getNumThreads();
+    cv::setNumThreads(1);
+    double time = measureMs([&]() {
+        for (int i = 0; i < nbFrames; ++i)
+            motionEstimator->estimate(qvgaVideo[i], medianFlows[i], blurScores[i]);
+    });
+    cv::setNumThreads(nbThreads);
+    float sharpBlur = 0.f, blurredBlur = 0.f;
+    for (int i = 0; i < nbFrames; ++i)
+        (i % 5 == 4 ? blurredBlur : sharpBlur) += blurScores[i];
+    LOG_INFO("Dense optical flow QVGA 1 thread: {} ms per frame, median flow {} pixels, blur score {} on sharp frames and {} on blurred frames",
+             time / nbFrames, medianFlows[1], sharpBlur / (nbFrames - nbFrames / 5), blurredBlur / (nbFrames / 5));
+}
+
+void benchmarkMatchesOverlay()
+{
+    const int nbFrames = 30;
+    const int nbMatches = 5000;
+    std::vector<SRef<Image>> video;
+    createMarkerVideo(2, video);
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> x(0.f, 1919.f), y(0.f, 1079.f);
+    std::vector<Point2Df> points1(nbMatches), points2(nbMatches);
+    for (int i = 0; i < nbMatches; ++i) {
+        points1[i] = Point2Df(x(rng), y(rng));
+        points2[i] = Point2Df(x(rng), y(rng));
+    }
+
+    // a new side-by-side image and a new random color per line, as the overlay did before its single rendering pass
+    double timeReference = measureMs([&]() {
+        std::uniform_int_distribution<int> uni(0, 255);
+        for (int i = 0; i < nbFrames; ++i) {
+            cv::Mat outImg(1080, 3840, CV_8UC3);
+            outImg.setTo(0);
+            SolAROpenCVHelper::mapToOpenCV(video[0]).copyTo(outImg(cv::Rect(0, 0, 1920, 1080)));
+            SolAROpenCVHelper::mapToOpenCV(video[1]).copyTo(outImg(cv::Rect(1920, 0, 1920, 1080)));
+            for (int j = 0; j < nbMatches; ++j)
+                cv::line(outImg, cv::Point2f(points1[j].getX(), points1[j].getY()), cv::Point2f(points2[j].getX() + 1920, points2[j].getY()),
+                         cv::Scalar(uni(rng), uni(rng), uni(rng)), 1);
+        }
+    });
+    LOG_INFO("Matches overlay 1080p {} matches: reference {} ms per frame", nbMatches, timeReference / nbFrames);
+
+    std::vector<std::pair<int, float>> settings = {{1, 1.f}, {4, 1.f}, {1, 0.5f}, {4, 0.5f}};
+    for (const auto & setting : settings) {
+        auto overlay = xpcf::ComponentFactory::createInstance<SolARMatchesOverlayOpencv>()->bindTo<api::display::IMatchesOverlay>();
+        auto configurable = overlay->bindTo<xpcf::IConfigurable>();
+        configurable->getProperty("mode")->setStringValue("RANDOM");
+        configurable->getProperty("lodStep")->setIntegerValue(setting.first);
+        configurable->getProperty("previewScale")->setFloatingValue(setting.second);
+        SRef<Image> outImage;
+        double time = measureMs([&]() {
+            for (int i = 0; i < nbFrames; ++i)
+                overlay->draw(video[0], video[1], outImage, points1, points2);
+        });
+        LOG_INFO("Matches overlay 1080p {} matches, lodStep {}, previewScale {}: {}x{} output, {} ms per frame",
+                 nbMatches, setting.first, setting.second, outImage->getWidth(), outImage->getHeight(), time / nbFrames);
+    }
+}
+
+void benchmarkImageViewer()
+{
+    const int nbFrames = 30;
+    std::vector<SRef<Image>> video;
+    createMarkerVideo(nbFrames, video);
+    const char * recordFile = "benchmark_viewer.avi";
+
+    // the frames encoded on the pipeline thread, against the RECORD backend of the viewer encoding them in the background
+    double timeWriter = measureMs([&]() {
+        cv::VideoWriter writer(recordFile, cv::VideoWriter::fourcc('M','J','P','G'), 30., cv::Size(1920, 1080));
+        for (int i = 0; i < nbFrames; ++i)
+            writer.write(SolAROpenCVHelper::mapToOpenCV(video[i]));
+    });
+    double timeViewer = 0.;
+    {
+        auto viewer = xpcf::ComponentFactory::createInstance<SolARImageViewerOpencv>()->bindTo<api::display::IImageViewer>();
+        auto configurable = viewer->bindTo<xpcf::IConfigurable>();
+        configurable->getProperty("backend")->setStringValue("RECORD");
+        configurable->getProperty("recordFile")->setStringValue(recordFile);
+        timeViewer = measureMs([&]() {
+            for (int i = 0; i < nbFrames; ++i)
+                viewer->display(video[i]);
+        });
+    }
+    std::remove(recordFile);
+    LOG_INFO("Recording 1080p BGR: {} ms per frame on the pipeline thread, {} ms per frame with the RECORD viewer backend",
+             timeWriter / nbFrames, timeViewer / nbFrames);
+}
+
+void benchmarkVideoRecorder()
+{
+    const int nbFrames = 30;
+    std::vector<SRef<Image>> video;
+    createMarkerVideo(nbFrames, video);
+    const std::string prefix = "benchmark_recorder";
+
+    // PNG images written on the pipeline thread, against the recorder writing them in the background
+    double timeImwrite = measureMs([&]() {
+        for (int i = 0; i < nbFrames; ++i)
+            cv::imwrite(prefix + cv::format("_%06d.png", i), SolAROpenCVHelper::mapToOpenCV(video[i]), {cv::IMWRITE_PNG_COMPRESSION, 1});
+    });
+    LOG_INFO("Recording 1080p BGR PNG: imwrite {} ms per frame", timeImwrite / nbFrames);
+    for (const char * dropPolicy : {"DROP_NEWEST", "BLOCK"}) {
+        auto recorder = xpcf::ComponentFactory::createInstance<SolARVideoRecorderOpencv>()->bindTo<IImageRecorder>();
+        auto configurable = recorder->bindTo<xpcf::IConfigurable>();
+        configurable->getProperty("outputPath")->setStringValue(prefix.c_str());
+        configurable->getProperty("format")->setStringValue("PNG");
+        configurable->getProperty("dropPolicy")->setStringValue(dropPolicy);
+        uint32_t maxQueueDepth = 0;
+        double timeRecord = measureMs([&]() {
+            for (int i = 0; i < nbFrames; ++i) {
+                recorder->record(video[i], i * 1000. / 30.);
+                maxQueueDepth = std::max(maxQueueDepth, recorder->getQueueDepth());
+            }
+        });
+        double timeClose = measureMs([&]() { recorder->close(); });
+        LOG_INFO("Recording 1080p BGR PNG, {}: record {} ms per frame, close {} ms, max queue depth {}, {} written, {} dropped",
+                 dropPolicy, timeRecord / nbFrames, timeClose, maxQueueDepth, recorder->getNbRecordedImages(), recorder->getNbDroppedImages());
+    }
+    for (int i = 0; i < nbFrames; ++i)
+        std::remove((prefix + cv::format("_%06d.png", i)).c_str());
+    std::remove((prefix + ".timestamps.txt").c_str());
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "--micro")
+        return runMicroBenchmarks(argc, argv);
+
+    // logs are kept in release mode, they carry the measures
+    LOG_ADD_LOG_TO_CONSOLE();
+
+    LOG_INFO("program is running");
+
+    benchmarkMapFusionDuplicates();
+    benchmarkUndistortion();
+    benchmarkMarkerTracking();
+    benchmarkContoursFilter();
+    benchmarkPerspectiveController();
+    benchmarkAdaptiveThreshold();
+    benchmarkImageFilterChain();
+    benchmarkFastGaussian();
+    benchmarkKeypointDetectorRegion();
+    benchmarkOpticalFlow();
+    benchmarkDenseOpticalFlow();
+    benchmarkMatchesOverlay();
+    benchmarkImageViewer();
+    benchmarkVideoRecorder();
+
+    return 0;
+}